@@ -40,6 +40,11 @@ function fetchAndUpdateDMX() {
     .then(data => {
         document.getElementById('universe').value = data.universe;
         document.getElementById('channel').value = data.channel;
+        document.getElementById('universes').value = data.universes;
+        document.getElementById('protocol').value = data.protocol;
+        document.getElementById('merge').value = data.merge;
+        document.getElementById('pacing').value = data.pacing;
+        document.getElementById('fps').value = data.fps;
     });
 }
 
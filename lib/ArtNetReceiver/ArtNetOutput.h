@@ -0,0 +1,133 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+
+/**
+ * Sends one universe as ArtDmx, e.g. sensor values back to the console.
+ *
+ * A packet is sent only when a channel changed, at most `maxRate` times per second, changes in between are sent together.
+ * The universe is repeated every `KEEP_ALIVE_MS` without changes, so the receivers don't time the source out.
+ * Only the channels up to the highest set one are sent.
+ */
+class ArtNetOutput {
+    public:
+        static const uint16_t PORT = 6454;
+        static const uint16_t HEADER_SIZE = 18;
+        static const uint16_t UNIVERSE_SIZE = 512;
+        static const unsigned long KEEP_ALIVE_MS = 4000;
+
+    private:
+        uint16_t universe;
+        uint32_t ip; // network order, 0 means the subnet broadcast
+        unsigned long minIntervalMillis;
+        int sock = -1;
+        uint8_t packet[HEADER_SIZE + UNIVERSE_SIZE] = {};
+        uint16_t length = 2; // ArtDmx length is even, min 2
+        uint8_t sequence = 0;
+        bool dirty = false;
+        unsigned long lastSentAt = 0;
+        uint32_t sentPackets = 0;
+
+        void send() {
+            uint32_t destination = ip;
+            if (destination == 0) {
+                destination = (uint32_t) WiFi.localIP() | ~(uint32_t) WiFi.subnetMask();
+            }
+            sequence = sequence == 255 ? 1 : sequence + 1; // 0 disables sequencing
+            packet[12] = sequence;
+            packet[16] = length >> 8;
+            packet[17] = length & 0xFF;
+
+            struct sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(PORT);
+            addr.sin_addr.s_addr = destination;
+            if (sendto(sock, packet, HEADER_SIZE + length, 0, (struct sockaddr*) &addr, sizeof(addr)) > 0) {
+                sentPackets++;
+            }
+            lastSentAt = millis();
+            dirty = false;
+        }
+
+    public:
+        /**
+         * `ip` is the destination, empty for the subnet broadcast.
+         */
+        ArtNetOutput(uint16_t universe, const char* ip, uint8_t maxRate):
+                universe(universe) {
+            IPAddress address;
+            this->ip = ip != nullptr && ip[0] != 0 && address.fromString(ip) ? (uint32_t) address : 0;
+            minIntervalMillis = maxRate > 0 ? 1000 / maxRate : 0;
+
+            memcpy(packet, "Art-Net", 8);
+            packet[8] = 0x00; // OpDmx, little endian
+            packet[9] = 0x50;
+            packet[11] = 14; // protocol version
+            packet[14] = universe & 0xFF; // sub-net and universe
+            packet[15] = (universe >> 8) & 0x7F; // net
+        }
+
+        ~ArtNetOutput() {
+            end();
+        }
+
+        bool begin() {
+            end();
+            sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+            if (sock < 0) {
+                Log.errorln("Art-Net output socket could not be created.");
+                return false;
+            }
+            int broadcast = 1;
+            setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast));
+            fcntl(sock, F_SETFL, O_NONBLOCK);
+            return true;
+        }
+
+        void end() {
+            if (sock >= 0) {
+                close(sock);
+                sock = -1;
+            }
+        }
+
+        /**
+         * Sets the channel (0 based) value, sent by the next `update`.
+         */
+        void set(uint16_t channel, uint8_t value) {
+            if (channel >= UNIVERSE_SIZE) {
+                return;
+            }
+            if (channel >= length) {
+                length = (channel + 2) & ~1;
+            }
+            if (packet[HEADER_SIZE + channel] != value) {
+                packet[HEADER_SIZE + channel] = value;
+                dirty = true;
+            }
+        }
+
+        /**
+         * Sends the pending changes once the rate allows it, call it from the loop.
+         */
+        void update() {
+            if (sock < 0 || !WiFi.isConnected()) {
+                return;
+            }
+            unsigned long now = millis();
+            if ((dirty && now - lastSentAt >= minIntervalMillis) || now - lastSentAt >= KEEP_ALIVE_MS) {
+                send();
+            }
+        }
+
+        uint16_t getUniverse() {
+            return universe;
+        }
+
+        uint32_t getSentPackets() {
+            return sentPackets;
+        }
+};
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <WiFi.h>
+#include <functional>
+#include <vector>
+#include <lwip/sockets.h>
+#include <DmxFrameAssembler.h>
+#include <DmxMerger.h>
+
+/**
+ * Art-Net receiver with a fast path for ArtDmx.
+ *
+ * Only the header is peeked first. Packets of other universes (and unknown OpCodes) are dropped after checking a few bytes,
+ * DMX data of accepted packets is received straight into the merger buffer of the source, no intermediate copy is made.
+ * ArtSync and ArtTimeCode are passed to the callbacks, ArtPoll is answered with ArtPollReply advertising all the received
+ * (and sent) universes as ports, so controllers can unicast to the node.
+ */
+class ArtNetReceiver {
+    public:
+        static const uint16_t PORT = 6454;
+        static const uint16_t HEADER_SIZE = 18; // ArtDmx header up to (including) the data length
+
+        static const uint16_t OP_POLL = 0x2000;
+        static const uint16_t OP_POLL_REPLY = 0x2100;
+        static const uint16_t OP_DMX = 0x5000;
+        static const uint16_t OP_SYNC = 0x5200;
+        static const uint16_t OP_TIMECODE = 0x9700;
+
+    private:
+        static const uint16_t POLL_REPLY_SIZE = 239;
+        static const uint16_t TIMECODE_SIZE = 19;
+
+        DmxFrameAssembler* assembler;
+        DmxMerger* merger;
+        int sock = -1;
+        uint8_t header[HEADER_SIZE];
+        std::function<void()> onSyncCallback;
+        std::function<void(uint32_t)> onTimeCodeCallback;
+
+        String shortName = "NetPins";
+        String longName = "NetPins";
+        uint32_t pollReplies = 0;
+        // universes sent by the node (e.g. by ArtNetOutput), advertised as input ports
+        std::vector<uint16_t> inputUniverses;
+
+        uint32_t packets = 0;
+        uint32_t rejectedPackets = 0;
+
+        static uint16_t read16(const uint8_t* data) {
+            return (data[0] << 8) | data[1];
+        }
+
+        static bool isArtNet(const uint8_t* data) {
+            return memcmp(data, "Art-Net", 8) == 0; // including the terminating 0
+        }
+
+        void discard() {
+            recv(sock, header, 1, 0); // UDP drops the rest of the datagram
+        }
+
+        void receiveTimeCode() {
+            uint8_t packet[TIMECODE_SIZE];
+            if (recv(sock, packet, TIMECODE_SIZE, 0) < TIMECODE_SIZE || !onTimeCodeCallback) {
+                return;
+            }
+            static const uint8_t FPS[] = {24, 25, 30, 30}; // film, EBU, drop frame (29.97), SMPTE
+            uint8_t fps = FPS[packet[18] & 0x03];
+            uint32_t seconds = (packet[17] * 60UL + packet[16]) * 60UL + packet[15];
+            onTimeCodeCallback(seconds * 1000UL + packet[14] * 1000UL / fps);
+        }
+
+        struct Port {
+            uint16_t universe;
+            bool input;
+        };
+
+        /**
+         * Sends one reply per group of up to 4 ports sharing the net and sub-net, ports are numbered by the bind index.
+         */
+        void sendPollReply(uint32_t ip) {
+            std::vector<Port> ports;
+            for (uint16_t i = 0; i < assembler->getNumUniverses(); i++) {
+                ports.push_back({(uint16_t) (assembler->getFirstUniverse() + i), false});
+            }
+            for (uint16_t universe : inputUniverses) {
+                ports.push_back({universe, true});
+            }
+            pollReplies++;
+            uint8_t bindIndex = 1;
+            for (size_t first = 0; first < ports.size(); bindIndex++) {
+                size_t last = first + 1;
+                while (last < ports.size() && last - first < 4 && (ports[last].universe & 0xFFF0) == (ports[first].universe & 0xFFF0)) {
+                    last++;
+                }
+                sendPollReply(ip, ports.data() + first, last - first, bindIndex);
+                first = last;
+            }
+        }
+
+        void sendPollReply(uint32_t ip, const Port* ports, uint8_t numPorts, uint8_t bindIndex) {
+            uint8_t reply[POLL_REPLY_SIZE] = {};
+            memcpy(reply, "Art-Net", 8);
+            reply[8] = OP_POLL_REPLY & 0xFF;
+            reply[9] = OP_POLL_REPLY >> 8;
+            IPAddress localIp = WiFi.localIP();
+            for (uint8_t i = 0; i < 4; i++) {
+                reply[10 + i] = localIp[i];
+                reply[207 + i] = localIp[i]; // bind ip
+            }
+            reply[14] = PORT & 0xFF;
+            reply[15] = PORT >> 8;
+            reply[18] = (ports[0].universe >> 8) & 0x7F; // net switch
+            reply[19] = (ports[0].universe >> 4) & 0x0F; // sub switch
+            reply[23] = 0xE0; // indicators normal, port-addresses set by network or web browser (web admin)
+            strncpy((char*) reply + 26, shortName.c_str(), 17);
+            strncpy((char*) reply + 44, longName.c_str(), 63);
+            snprintf((char*) reply + 108, 64, "#0001 [%04u] OK", (unsigned int) (pollReplies % 10000));
+            reply[173] = numPorts;
+            for (uint8_t i = 0; i < numPorts; i++) {
+                if (ports[i].input) {
+                    reply[174 + i] = 0x40; // input, DMX512
+                    reply[178 + i] = 0x80; // good input, data received
+                    reply[186 + i] = ports[i].universe & 0x0F; // sw in
+                } else {
+                    reply[174 + i] = 0x80; // output, DMX512
+                    reply[182 + i] = 0x80 | (merger != nullptr && merger->getMode() == DmxMerger::LTP ? 0x02 : 0x00); // data is being transmitted, merge mode
+                    reply[190 + i] = ports[i].universe & 0x0F; // sw out
+                    reply[213 + i] = 0xC0; // good output B: RDM disabled, continuous output
+                }
+            }
+            reply[200] = 0x00; // StNode
+            WiFi.macAddress(reply + 201);
+            reply[211] = bindIndex;
+            reply[212] = 0x09; // web configuration, 15 bit port-address supported
+
+            struct sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(PORT);
+            addr.sin_addr.s_addr = ip;
+            sendto(sock, reply, POLL_REPLY_SIZE, 0, (struct sockaddr*) &addr, sizeof(addr));
+        }
+
+    public:
+        ArtNetReceiver(DmxFrameAssembler* assembler, DmxMerger* merger):
+                assembler(assembler),
+                merger(merger) {
+        }
+
+        ~ArtNetReceiver() {
+            end();
+        }
+
+        void setShortName(String name) {
+            shortName = name;
+        }
+
+        void setLongName(String name) {
+            longName = name;
+        }
+
+        /**
+         * Advertises the universe as an input port in ArtPollReply.
+         */
+        void addInputUniverse(uint16_t universe) {
+            inputUniverses.push_back(universe);
+        }
+
+        void setOnSyncCallback(std::function<void()> callback) {
+            onSyncCallback = callback;
+        }
+
+        /**
+         * The callback receives the timecode in ms.
+         */
+        void setOnTimeCodeCallback(std::function<void(uint32_t)> callback) {
+            onTimeCodeCallback = callback;
+        }
+
+        bool begin() {
+            end();
+            sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+            if (sock < 0) {
+                Log.errorln("Art-Net socket could not be created.");
+                return false;
+            }
+            int reuse = 1;
+            setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            struct sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(PORT);
+            addr.sin_addr.s_addr = htonl(INADDR_ANY);
+            if (bind(sock, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+                Log.errorln("Art-Net socket could not be bound to port %d.", PORT);
+                end();
+                return false;
+            }
+            fcntl(sock, F_SETFL, O_NONBLOCK);
+            return true;
+        }
+
+        void end() {
+            if (sock >= 0) {
+                close(sock);
+                sock = -1;
+            }
+        }
+
+        /**
+         * Receives all the pending packets. Returns true if at least one universe was updated.
+         */
+        bool parse() {
+            if (sock < 0) {
+                return false;
+            }
+            bool updated = false;
+            while (true) {
+                struct sockaddr_in from = {};
+                socklen_t fromLength = sizeof(from);
+                int size = recvfrom(sock, header, HEADER_SIZE, MSG_PEEK, (struct sockaddr*) &from, &fromLength);
+                if (size < 0) {
+                    break; // EWOULDBLOCK, nothing to read
+                }
+                packets++;
+                if (size < 10 || !isArtNet(header)) {
+                    rejectedPackets++;
+                    discard();
+                    continue;
+                }
+                uint16_t opCode = header[8] | (header[9] << 8);
+                if (opCode == OP_TIMECODE) {
+                    receiveTimeCode();
+                    continue;
+                }
+                if (opCode != OP_DMX) {
+                    discard();
+                    if (opCode == OP_SYNC) {
+                        if (onSyncCallback) {
+                            onSyncCallback();
+                        }
+                    } else if (opCode == OP_POLL) {
+                        sendPollReply(from.sin_addr.s_addr);
+                    }
+                    continue;
+                }
+
+                // 15 bit port-address: net (7 bits), sub-net and universe (4 bits each)
+                uint16_t universe = header[14] | ((header[15] & 0x7F) << 8);
+                if (size < HEADER_SIZE || !assembler->accepts(universe)) {
+                    rejectedPackets++;
+                    discard();
+                    continue;
+                }
+                uint8_t* data = merger->beginPacket(from.sin_addr.s_addr, universe, header[12]);
+                if (data == nullptr) {
+                    rejectedPackets++;
+                    discard();
+                    continue;
+                }
+                uint16_t length = read16(header + 16);
+                if (length > DmxFrameAssembler::UNIVERSE_SIZE) {
+                    length = DmxFrameAssembler::UNIVERSE_SIZE;
+                }
+
+                // receive the header again and the DMX data straight into the source buffer
+                struct iovec iov[2];
+                iov[0].iov_base = header;
+                iov[0].iov_len = HEADER_SIZE;
+                iov[1].iov_base = data;
+                iov[1].iov_len = length;
+                struct msghdr msg = {};
+                msg.msg_iov = iov;
+                msg.msg_iovlen = 2;
+                int received = recvmsg(sock, &msg, 0);
+                if (received < HEADER_SIZE) {
+                    // the merger ignores the packet without `endPacket`
+                    rejectedPackets++;
+                    continue;
+                }
+                merger->endPacket(received - HEADER_SIZE);
+                updated = true;
+            }
+            return updated;
+        }
+
+        uint32_t getPackets() {
+            return packets;
+        }
+
+        /**
+         * Packets dropped early: not Art-Net, universes not listened to, rejected by the merger or failed to be received.
+         */
+        uint32_t getRejectedPackets() {
+            return rejectedPackets;
+        }
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <functional>
+#include <lwip/sockets.h>
+
+/**
+ * DDP (Distributed Display Protocol) receiver.
+ *
+ * The pixel data is addressed by a byte offset into one flat output space, there are no universes. Each packet is passed
+ * to the data callback as is, the output is latched on the push flag. Senders which never set the push flag are latched
+ * after each packet.
+ *
+ * Only the default output (destination ID 1) is supported, queries, status and config packets are dropped.
+ */
+class DdpReceiver {
+    public:
+        static const uint16_t PORT = 4048;
+        static const uint16_t HEADER_SIZE = 10;
+        static const uint16_t TIMECODE_SIZE = 4;
+        static const uint16_t MAX_DATA_SIZE = 1440;
+        static const unsigned long PUSH_TIMEOUT_MS = 4000; // falls back to latching each packet
+
+        static const uint8_t FLAG_VERSION_MASK = 0xC0;
+        static const uint8_t FLAG_VERSION_1 = 0x40;
+        static const uint8_t FLAG_TIMECODE = 0x10;
+        static const uint8_t FLAG_QUERY = 0x02;
+        static const uint8_t FLAG_PUSH = 0x01;
+        static const uint8_t ID_DISPLAY = 1;
+
+    private:
+        int sock = -1;
+        uint8_t packet[HEADER_SIZE + TIMECODE_SIZE + MAX_DATA_SIZE];
+        std::function<void(uint32_t, const uint8_t*, uint16_t)> onDataCallback;
+        unsigned long lastPushAt = 0;
+        bool pushSeen = false;
+
+        uint32_t packets = 0;
+        uint32_t rejectedPackets = 0;
+        uint32_t pushes = 0;
+
+    public:
+        ~DdpReceiver() {
+            end();
+        }
+
+        /**
+         * The callback receives the byte offset, the data and the data length.
+         */
+        void setOnDataCallback(std::function<void(uint32_t, const uint8_t*, uint16_t)> callback) {
+            onDataCallback = callback;
+        }
+
+        bool begin() {
+            end();
+            sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+            if (sock < 0) {
+                Log.errorln("DDP socket could not be created.");
+                return false;
+            }
+            int reuse = 1;
+            setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            struct sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(PORT);
+            addr.sin_addr.s_addr = htonl(INADDR_ANY);
+            if (bind(sock, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+                Log.errorln("DDP socket could not be bound to port %d.", PORT);
+                end();
+                return false;
+            }
+            fcntl(sock, F_SETFL, O_NONBLOCK);
+            return true;
+        }
+
+        void end() {
+            if (sock >= 0) {
+                close(sock);
+                sock = -1;
+            }
+        }
+
+        /**
+         * Receives all the pending packets. Returns true if the output should be latched.
+         */
+        bool parse() {
+            if (sock < 0) {
+                return false;
+            }
+            bool latch = false;
+            while (true) {
+                int size = recv(sock, packet, sizeof(packet), 0);
+                if (size < 0) {
+                    break; // EWOULDBLOCK, nothing to read
+                }
+                packets++;
+                uint8_t flags = packet[0];
+                if (size < HEADER_SIZE || (flags & FLAG_VERSION_MASK) != FLAG_VERSION_1 || (flags & FLAG_QUERY)
+                        || (packet[3] != ID_DISPLAY && packet[3] != 0)) {
+                    rejectedPackets++;
+                    continue;
+                }
+                uint16_t dataOffset = HEADER_SIZE + ((flags & FLAG_TIMECODE) ? TIMECODE_SIZE : 0);
+                uint32_t offset = ((uint32_t) packet[4] << 24) | ((uint32_t) packet[5] << 16) | ((uint32_t) packet[6] << 8) | packet[7];
+                uint16_t length = (packet[8] << 8) | packet[9];
+                if (dataOffset + length > size) {
+                    rejectedPackets++;
+                    continue;
+                }
+                if (length > 0 && onDataCallback) {
+                    onDataCallback(offset, packet + dataOffset, length);
+                }
+                if (flags & FLAG_PUSH) {
+                    pushes++;
+                    pushSeen = true;
+                    lastPushAt = millis();
+                    latch = true;
+                } else if (!pushSeen || millis() - lastPushAt > PUSH_TIMEOUT_MS) {
+                    pushSeen = false;
+                    latch = true;
+                }
+            }
+            return latch;
+        }
+
+        uint32_t getPackets() {
+            return packets;
+        }
+
+        uint32_t getRejectedPackets() {
+            return rejectedPackets;
+        }
+
+        uint32_t getPushes() {
+            return pushes;
+        }
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <TaskScheduler.h>
+#include <DmxStateStore.h>
+
+/**
+ * Periodically stores the DMX state so the last look survives a power loss.
+ * Flash writes are limited by the hourly budget, changes beyond the budget are stored in the next hour.
+ * Runs without a change since the last store (see `DmxStateStore::markChanged`) don't compare the data.
+ */
+class DmxAutosave: public Task {
+    private:
+        DmxStateStore* store;
+        const uint8_t* data;
+        uint16_t maxWritesPerHour;
+        unsigned long windowStartedAt = 0;
+        uint16_t windowWrites = 0;
+        uint32_t skipped = 0;
+
+    public:
+        DmxAutosave(Scheduler* aScheduler, DmxStateStore* store, const uint8_t* data, unsigned long interval, uint16_t maxWritesPerHour):
+                store(store),
+                data(data),
+                maxWritesPerHour(maxWritesPerHour),
+                Task(interval, TASK_FOREVER, aScheduler, false) {
+            if (interval > 0) {
+                this->enable();
+            }
+        }
+
+        bool Callback() {
+            if (!store->isChanged()) {
+                return true;
+            }
+            if (millis() - windowStartedAt >= 3600000UL) {
+                windowStartedAt = millis();
+                windowWrites = 0;
+            }
+            if (maxWritesPerHour > 0 && windowWrites >= maxWritesPerHour) {
+                skipped++;
+                return true;
+            }
+            if (store->store(data)) {
+                windowWrites++;
+            }
+            return true;
+        }
+
+        /**
+         * Autosave runs skipped because the hourly write budget was used up.
+         */
+        uint32_t getSkipped() {
+            return skipped;
+        }
+};
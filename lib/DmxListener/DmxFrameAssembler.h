@@ -0,0 +1,174 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <DmxFrameBuffer.h>
+
+/**
+ * Assembles N consecutive universes into one contiguous channel space.
+ *
+ * Universe `firstUniverse + i` occupies bytes `i * 512 ... i * 512 + 511` of the frame.
+ * A frame is committed when all the universes of the frame arrived. If some universe is lost,
+ * the frame is committed when the timeout expires or when the next frame starts (the same universe arrives again).
+ * Universes which did not arrive keep their last values.
+ *
+ * Universe data is written straight into the write slot of the frame buffer, committed frames are published to the reader.
+ */
+class DmxFrameAssembler {
+    public:
+        static const uint16_t UNIVERSE_SIZE = 512;
+        static const uint8_t MAX_UNIVERSES = 32;
+
+    private:
+        uint16_t firstUniverse;
+        uint8_t numUniverses;
+        unsigned long timeoutMillis;
+        DmxFrameBuffer* frameBuffer;
+        uint32_t receivedMask = 0;
+        uint32_t completeMask;
+        unsigned long frameStartedAt = 0;
+
+        uint32_t completeFrames = 0;
+        uint32_t incompleteFrames = 0;
+
+        void commit() {
+            if (receivedMask == completeMask) {
+                completeFrames++;
+            } else {
+                incompleteFrames++;
+                Log.traceln("Committing incomplete DMX frame, received universes mask: %x.", receivedMask);
+                // the write slot holds an older frame, take the missing universes from the last published frame
+                const uint8_t* lastFrame = frameBuffer->lastPublished();
+                if (lastFrame != nullptr) {
+                    uint8_t* frame = frameBuffer->writeSlot();
+                    for (uint8_t i = 0; i < numUniverses; i++) {
+                        if (!(receivedMask & (1UL << i))) {
+                            memcpy(frame + i * UNIVERSE_SIZE, lastFrame + i * UNIVERSE_SIZE, UNIVERSE_SIZE);
+                        }
+                    }
+                }
+            }
+            receivedMask = 0;
+            frameBuffer->publish();
+        }
+
+    public:
+        /**
+         * `bufferFrames` is the number of frames in the ring between the receiving and the rendering side.
+         */
+        DmxFrameAssembler(uint16_t firstUniverse, uint8_t numUniverses, uint8_t bufferFrames = 3, unsigned long timeoutMillis = 15):
+                firstUniverse(firstUniverse),
+                timeoutMillis(timeoutMillis) {
+            if (numUniverses == 0) {
+                numUniverses = 1;
+            } else if (numUniverses > MAX_UNIVERSES) {
+                Log.errorln("Max %d universes supported, %d requested.", MAX_UNIVERSES, numUniverses);
+                numUniverses = MAX_UNIVERSES;
+            }
+            this->numUniverses = numUniverses;
+            completeMask = numUniverses == 32 ? UINT32_MAX : (1UL << numUniverses) - 1;
+            frameBuffer = new DmxFrameBuffer(length(), bufferFrames);
+        }
+
+        ~DmxFrameAssembler() {
+            delete frameBuffer;
+        }
+
+        /**
+         * Buffer the assembled frames are published to.
+         */
+        DmxFrameBuffer* getFrameBuffer() {
+            return frameBuffer;
+        }
+
+        /**
+         * Returns true if the universe is part of the assembled channel space.
+         */
+        bool accepts(uint16_t universe) {
+            return universe >= firstUniverse && universe < firstUniverse + numUniverses;
+        }
+
+        /**
+         * Returns the 512 bytes buffer the universe data have to be written to, or nullptr if the universe is not assembled.
+         * When the universe was already received in the current frame, the current (incomplete) frame is committed first.
+         */
+        uint8_t* beginUniverse(uint16_t universe) {
+            if (!accepts(universe)) {
+                return nullptr;
+            }
+            uint32_t bit = 1UL << (universe - firstUniverse);
+            if (receivedMask & bit) {
+                commit();
+            }
+            return frameBuffer->writeSlot() + (universe - firstUniverse) * UNIVERSE_SIZE;
+        }
+
+        /**
+         * Marks the universe as received, `length` bytes were written to the buffer returned by `beginUniverse`.
+         * Channels behind the length are zeroed. The frame is committed once all the universes arrived.
+         */
+        void endUniverse(uint16_t universe, uint16_t length) {
+            if (!accepts(universe)) {
+                return;
+            }
+            uint8_t index = universe - firstUniverse;
+            if (length < UNIVERSE_SIZE) {
+                memset(frameBuffer->writeSlot() + index * UNIVERSE_SIZE + length, 0, UNIVERSE_SIZE - length);
+            }
+            if (receivedMask == 0) {
+                frameStartedAt = millis();
+            }
+            receivedMask |= 1UL << index;
+            if (receivedMask == completeMask) {
+                commit();
+            }
+        }
+
+        /**
+         * Commits the incomplete frame if the timeout expired. Call it regularly from the receiving side.
+         */
+        void poll() {
+            if (receivedMask != 0 && millis() - frameStartedAt > timeoutMillis) {
+                commit();
+            }
+        }
+
+        /**
+         * Commits the incomplete frame right away (eg. on sync). Call it from the receiving side.
+         */
+        void flush() {
+            if (receivedMask != 0) {
+                commit();
+            }
+        }
+
+        /**
+         * Time an incomplete frame waits for the missing universes.
+         */
+        unsigned long getTimeout() {
+            return timeoutMillis;
+        }
+
+        uint16_t getFirstUniverse() {
+            return firstUniverse;
+        }
+
+        uint8_t getNumUniverses() {
+            return numUniverses;
+        }
+
+        /**
+         * Length of the assembled channel space in bytes.
+         */
+        uint16_t length() {
+            return numUniverses * UNIVERSE_SIZE;
+        }
+
+        uint32_t getCompleteFrames() {
+            return completeFrames;
+        }
+
+        uint32_t getIncompleteFrames() {
+            return incompleteFrames;
+        }
+};
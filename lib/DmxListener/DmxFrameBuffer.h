@@ -0,0 +1,126 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * Lock-free handoff of complete DMX frames from the receiving side (single writer) to the rendering side (single reader).
+ *
+ * Frames are kept in a ring of slots. The writer fills its slot in place and publishes it when the frame is complete,
+ * the reader always takes the newest published frame without blocking. Older published frames the reader did not
+ * take are dropped. The writer never touches a published slot, so frames can't tear.
+ */
+class DmxFrameBuffer {
+    private:
+        uint16_t frameLength;
+        uint8_t numSlots;
+        uint8_t* slots;
+        // micros() when the frame in the slot was published
+        uint32_t* publishedAt;
+
+        // number of published frames, written by the writer only
+        std::atomic<uint32_t> head{0};
+        // number of published frames consumed (or skipped) by the reader, written by the reader only
+        std::atomic<uint32_t> tail{0};
+
+        std::atomic<uint32_t> droppedFrames{0};
+        std::atomic<uint32_t> overflowFrames{0};
+
+        uint8_t* slot(uint32_t index) {
+            return slots + (index % numSlots) * frameLength;
+        }
+
+    public:
+        /**
+         * 3 slots are enough for a reader copying the frame out immediately (triple buffering).
+         */
+        DmxFrameBuffer(uint16_t frameLength, uint8_t numSlots = 3):
+                frameLength(frameLength),
+                numSlots(numSlots < 3 ? 3 : numSlots) {
+            slots = new uint8_t[this->numSlots * frameLength]();
+            publishedAt = new uint32_t[this->numSlots]();
+        }
+
+        ~DmxFrameBuffer() {
+            delete[] slots;
+            delete[] publishedAt;
+        }
+
+        /**
+         * Writer side. Slot the next frame is written to.
+         */
+        uint8_t* writeSlot() {
+            return slot(head.load(std::memory_order_relaxed));
+        }
+
+        /**
+         * Writer side. Last published frame, nullptr if there is none.
+         */
+        const uint8_t* lastPublished() {
+            uint32_t h = head.load(std::memory_order_relaxed);
+            return h == 0 ? nullptr : slot(h - 1);
+        }
+
+        /**
+         * Writer side. Publishes the write slot. If the reader fell behind the whole ring,
+         * the frame is not published and the write slot is reused for the next frame.
+         */
+        bool publish() {
+            uint32_t h = head.load(std::memory_order_relaxed);
+            // keep the write slot out of the published range [tail, head)
+            if (h + 1 - tail.load(std::memory_order_acquire) >= numSlots) {
+                overflowFrames.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            publishedAt[h % numSlots] = micros();
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Reader side. Copies the newest published frame into `frame`, returns false if no new frame was published
+         * since the last call. Published frames older than the newest one are dropped.
+         * `framePublishedAt` is set to micros() of the frame publishing.
+         */
+        bool takeLatest(uint8_t* frame, uint32_t* framePublishedAt = nullptr) {
+            uint32_t h = head.load(std::memory_order_acquire);
+            uint32_t t = tail.load(std::memory_order_relaxed);
+            if (h == t) {
+                return false;
+            }
+            memcpy(frame, slot(h - 1), frameLength);
+            if (framePublishedAt != nullptr) {
+                *framePublishedAt = publishedAt[(h - 1) % numSlots];
+            }
+            if (h - t > 1) {
+                droppedFrames.fetch_add(h - t - 1, std::memory_order_relaxed);
+            }
+            tail.store(h, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Reader side. Returns true if a frame was published since the last `takeLatest`.
+         */
+        bool hasNewFrame() {
+            return head.load(std::memory_order_acquire) != tail.load(std::memory_order_relaxed);
+        }
+
+        uint16_t getFrameLength() {
+            return frameLength;
+        }
+
+        /**
+         * Frames replaced by a newer frame before the reader took them.
+         */
+        uint32_t getDroppedFrames() {
+            return droppedFrames.load(std::memory_order_relaxed) + overflowFrames.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Frames not published because the reader fell behind the whole ring, included in `getDroppedFrames`.
+         */
+        uint32_t getOverflowFrames() {
+            return overflowFrames.load(std::memory_order_relaxed);
+        }
+};
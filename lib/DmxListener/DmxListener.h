@@ -3,22 +3,89 @@
 #include <Arduino.h>
 #include <ArduinoLog.h>
 #include <vector>
+#include <algorithm>
 #include <Things.h>
-#include <Preferences.h>
-#include <ArduinoLog.h>
 
 /**
  * Each controller has one DmxListener instance to handle DMX data.
  * 
  * Dmx listener controls things, which are simple leds, pxiels on led stipes or group of pixels on led stripe.
  * Things has different number of channles.
+ *
+ * Only things whose channels changed since the last processed frame are updated.
+ *
+ * The thing list is compiled into a flat dispatch table (thing, 1st channel, number of channels) and a name index,
+ * the table is rebuilt only when things are added or removed.
+ *
+ * A thing is either patched explicitly (1st channel in the channel space) or mapped sequentially from the first DMX channel,
+ * things patched explicitly don't take channels of the sequential block. The dispatch table is sorted by channel and split
+ * per universe, universes which did not change are skipped as a whole.
  */
 class DmxListener {
     private:
+        struct ThingChannels {
+            Thing* thing;
+            uint16_t firstChannel; // index in the channel space
+            uint16_t width;
+        };
+
+        struct NamedChannel {
+            String name;
+            uint16_t firstChannel;
+        };
+
+        struct PatchedThing {
+            Thing* thing;
+            int firstChannel; // -1 means sequential
+        };
+
+        // dispatch table entries of the things starting in the universe and channels they span
+        struct UniverseWindow {
+            uint16_t begin;
+            uint16_t end;
+            uint16_t firstChannel;
+            uint16_t endChannel;
+        };
+
+        static const uint16_t UNIVERSE_SIZE = 512;
+
         int firstDmxChannel;
-        std::vector<Thing*> thingList;
-        Preferences preferences;
-        uint8_t lastStoreFlag = 0;
+        std::vector<PatchedThing> thingList;
+
+        std::vector<ThingChannels> dispatchTable;
+        std::vector<UniverseWindow> universeWindows;
+        // sorted by name
+        std::vector<NamedChannel> nameIndex;
+        bool compiled = false;
+        uint16_t compiledLength = 0;
+
+        // copy of the last processed frame
+        uint8_t* lastData = nullptr;
+        uint16_t lastDataLength = 0;
+        // when set, all the things are updated by the next frame
+        bool forceUpdate = true;
+
+        /**
+         * Compares the channels 4 bytes at a time.
+         */
+        static bool changed(const uint8_t* data, const uint8_t* lastData, uint16_t length) {
+            uint16_t i = 0;
+            for (; i + 4 <= length; i += 4) {
+                uint32_t word;
+                uint32_t lastWord;
+                memcpy(&word, data + i, 4); // unaligned safe, compiles to a single load when aligned
+                memcpy(&lastWord, lastData + i, 4);
+                if (word != lastWord) {
+                    return true;
+                }
+            }
+            for (; i < length; i++) {
+                if (data[i] != lastData[i]) {
+                    return true;
+                }
+            }
+            return false;
+        }
 
     public:
         DmxListener(int firstDmxChannel):
@@ -27,84 +94,137 @@ class DmxListener {
 
         ~DmxListener() {
             clearThings();
+            delete[] lastData;
+        }
+
+        /**
+         * Builds the dispatch table and the name index, things not fitting into the channel space of `length` bytes are skipped.
+         */
+        void compile(uint16_t length) {
+            dispatchTable.clear();
+            nameIndex.clear();
+            int currentDmxIndex = firstDmxChannel - 1; // 1st channel is 1 (means 0 in the art-net data array)
+            for (auto& patched : thingList) {
+                Thing* thing = patched.thing;
+                int width = thing->numChannels();
+                int firstChannel = patched.firstChannel >= 0 ? patched.firstChannel : currentDmxIndex;
+                if (patched.firstChannel < 0) {
+                    currentDmxIndex += width;
+                }
+                if (firstChannel + width > length) {
+                    Log.warningln("Missing DMX data for thing. 1st dmx ch %d, num ch: %d. Data length: %d.", firstChannel, width, length);
+                    continue;
+                }
+                dispatchTable.push_back({thing, (uint16_t) firstChannel, (uint16_t) width});
+                if (thing->getName().length() > 0) {
+                    nameIndex.push_back({thing->getName(), (uint16_t) firstChannel});
+                }
+            }
+            std::stable_sort(dispatchTable.begin(), dispatchTable.end(), [](const ThingChannels& a, const ThingChannels& b) {
+                return a.firstChannel < b.firstChannel;
+            });
+            std::stable_sort(nameIndex.begin(), nameIndex.end(), [](const NamedChannel& a, const NamedChannel& b) {
+                return strcmp(a.name.c_str(), b.name.c_str()) < 0;
+            });
+
+            universeWindows.assign((length + UNIVERSE_SIZE - 1) / UNIVERSE_SIZE, UniverseWindow{0, 0, 0, 0});
+            for (uint16_t i = 0; i < dispatchTable.size(); i++) {
+                const auto& entry = dispatchTable[i];
+                auto& window = universeWindows[entry.firstChannel / UNIVERSE_SIZE];
+                if (window.begin == window.end) {
+                    window = {i, i, entry.firstChannel, entry.firstChannel};
+                }
+                window.end = i + 1;
+                if (entry.firstChannel + entry.width > window.endChannel) {
+                    window.endChannel = entry.firstChannel + entry.width;
+                }
+            }
+            compiledLength = length;
+            compiled = true;
+            forceUpdate = true;
+            Log.noticeln("DMX dispatch table compiled, %d things, %d named.", dispatchTable.size(), nameIndex.size());
         }
 
-        void addThing(Thing* thing) {
-            thingList.push_back(thing);
+        /**
+         * `firstChannel` is the index of the 1st channel of the thing in the channel space (0 based),
+         * -1 maps the thing sequentially after the previous sequentially mapped thing.
+         */
+        void addThing(Thing* thing, int firstChannel = -1) {
+            thingList.push_back({thing, firstChannel});
+            compiled = false;
         }
 
         void removeThing(Thing* thing) {
-            auto it = std::remove(thingList.begin(), thingList.end(), thing);
+            auto it = std::remove_if(thingList.begin(), thingList.end(), [thing](const PatchedThing& patched) {
+                return patched.thing == thing;
+            });
             if (it != thingList.end()) {
-                thingList.erase(it);
+                thingList.erase(it, thingList.end());
             }
+            compiled = false;
         }
 
         void clearThings() {
-            for (auto& thing : thingList) {
-                delete thing;
+            for (auto& patched : thingList) {
+                delete patched.thing;
             }
             thingList.clear();
+            compiled = false;
         }
 
-        void processDmxData(uint16_t length, uint8_t data[512]) {
-            int currentDmxIndex = firstDmxChannel - 1; // 1st channel is 1 (means 0 in the art-net data array)
-            for (auto& thing : thingList) {
-                // get the data for the thing based on the number of channels it needs
-                if (currentDmxIndex + thing->numChannels() > length) {
-                    Log.warningln("Missing DMX data for thing. 1st dmx ch %d, num ch: %d. Data length: %d.", currentDmxIndex, thing->numChannels(), length);
-                    break;
-                } else {
-                    // Log.traceln("Setting data for thing with %d channels. Data: %d %d %d %d %d", thing->numChannels(), data[currentDmxIndex], data[currentDmxIndex + 1], data[currentDmxIndex + 2], data[currentDmxIndex + 3], data[currentDmxIndex + 4]);
-                    // data is a pointer to the first element of the array
-                    thing->setData(data + currentDmxIndex);                                
-                    currentDmxIndex += thing->numChannels();
-                }
-            }
+        /**
+         * Update all the things by the next frame, use when things were changed outside of the listener (eg. by DDP).
+         */
+        void invalidate() {
+            forceUpdate = true;
         }
 
-        boolean storeDmxData(uint8_t data[512]) {
-            // check if the data is the same as the last stored data
-            uint8_t storedData[512] = {0};
-            preferences.begin("dmx-state", true);
-            preferences.getBytes("data", storedData, 512);
-            preferences.end();
-            bool sameData = true;
-            for (int i = 0; i < 512; i++) {
-                if (data[i] != storedData[i]) {
-                    sameData = false;
-                    break;
-                }
+        /**
+         * Dispatches the channel space to the things. The channel space might span multiple consecutive universes,
+         * `length` is the number of bytes available in `data`. Returns true if some thing was updated.
+         */
+        bool processDmxData(uint16_t length, uint8_t* data) {
+            if (lastDataLength != length) {
+                delete[] lastData;
+                lastData = new uint8_t[length];
+                lastDataLength = length;
+                forceUpdate = true;
             }
-            if (sameData) {
-                Log.noticeln("DMX data is the same as the last stored data.");
-                return false;
+            if (!compiled || compiledLength != length) {
+                compile(length);
             }
-
-            preferences.begin("dmx-state", false);
-            preferences.putBytes("data", data, 512);
-            preferences.end();
-            Log.infoln("DMX data stored.");
-            return true;
-        }
-
-        void restoreDmxData(uint8_t dmxData[512]) {
-            preferences.begin("dmx-state", true);
-            preferences.getBytes("data", dmxData, 512);
-            preferences.end();
+            bool updated = false;
+            for (const auto& window : universeWindows) {
+                if (window.begin == window.end || (!forceUpdate
+                        && !changed(data + window.firstChannel, lastData + window.firstChannel, window.endChannel - window.firstChannel))) {
+                    continue;
+                }
+                for (uint16_t i = window.begin; i < window.end; i++) {
+                    const auto& entry = dispatchTable[i];
+                    // data is a pointer to the first element of the array
+                    uint8_t* thingData = data + entry.firstChannel;
+                    if (forceUpdate || changed(thingData, lastData + entry.firstChannel, entry.width)) {
+                        entry.thing->setData(thingData);
+                        updated = true;
+                    }
+                }
+            }
+            memcpy(lastData, data, length);
+            forceUpdate = false;
+            return updated;
         }
 
         /**
-         * Get the index of the first channel of the thing with the given name.
-         * The index is 0 based, so the first channel is 0.
+         * Get the index of the first channel of the thing with the given name in the channel space (DMX data array).
+         * The index is 0 based and includes the first DMX channel offset.
+         * The dispatch table must be compiled, see `compile`.
          */
-        int getThingChannelIndex(String name) {
-            int channel = 0; // channel variable contains the last channel of the last thing compared in the loop
-            for (auto& thing : thingList) {
-                if (thing->getName().equals(name)) {
-                    return channel;
-                }
-                channel += thing->numChannels();
+        int getThingChannelIndex(const char* name) {
+            auto it = std::lower_bound(nameIndex.begin(), nameIndex.end(), name, [](const NamedChannel& entry, const char* name) {
+                return strcmp(entry.name.c_str(), name) < 0;
+            });
+            if (it != nameIndex.end() && strcmp(it->name.c_str(), name) == 0) {
+                return it->firstChannel;
             }
             return -1; // not found
         }
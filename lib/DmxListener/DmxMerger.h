@@ -0,0 +1,340 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <vector>
+#include <DmxFrameAssembler.h>
+
+/**
+ * Merges DMX data of multiple sources (eg. main and backup console, media server) into the frame assembler.
+ *
+ * Each source (identified by IP address) has its own copy of the channel space and its own sequence tracking per universe.
+ * HTP takes the highest value of all active sources per channel, LTP takes the universe of the source which changed it last.
+ *
+ * Packets only update the copy of their source. The sources are merged into the assembler once per frame (tick), when
+ * the lead source (active for the longest time) delivered all the universes, on `flush` (ArtSync), or when the frame
+ * timeout of the assembler expires (see `poll`), so packets of sources sending only on change are not delayed longer.
+ * All the universes are merged at once, the published frame never mixes universes of different ticks.
+ * A source is dropped after it stops sending for the timeout period, the next oldest source becomes the lead.
+ *
+ * The receiver writes the universe data straight into the copy of the source, see `beginPacket` and `endPacket`.
+ * The packet counts (source activation, sequence, statistics) only once `endPacket` confirms it was received.
+ */
+class DmxMerger {
+    public:
+        enum Mode {
+            HTP,
+            LTP
+        };
+
+        static const uint8_t MAX_SOURCES = 4;
+
+        struct SourceStats {
+            uint32_t ip;
+            uint32_t packets;
+            uint32_t droppedPackets;
+            uint32_t lostPackets;
+            bool active;
+        };
+
+    private:
+        struct Source {
+            uint32_t ip = 0;
+            bool active = false;
+            unsigned long activeSince = 0;
+            unsigned long lastSeenAt = 0;
+            uint32_t packets = 0;
+            uint32_t droppedPackets = 0;
+            uint32_t lostPackets = 0; // sequence gaps, packets dropped by the network or the socket
+            uint8_t* lastSequences = nullptr; // per universe, 0 means not tracked
+            uint8_t* data = nullptr; // channel space of the source
+            uint32_t* hashes = nullptr; // per universe, used by LTP to detect changes
+        };
+
+        DmxFrameAssembler* assembler;
+        Mode mode;
+        unsigned long sourceTimeoutMillis;
+        Source sources[MAX_SOURCES];
+        // source which changed the universe last, used by LTP
+        uint8_t* ltpSources;
+        uint32_t rejectedPackets = 0;
+
+        // packet being received, see `beginPacket`
+        Source* packetSource = nullptr;
+        uint16_t packetUniverse = 0;
+        uint8_t packetSequence = 0;
+
+        // its packets mark the frame boundary
+        Source* lead = nullptr;
+        // universes received from the lead in the current frame
+        uint32_t leadMask = 0;
+        uint32_t completeMask;
+        // packets merged into the source copies since the last commit
+        bool pending = false;
+        unsigned long pendingSince = 0;
+
+        /**
+         * FNV-1a over 4 bytes words.
+         */
+        static uint32_t hash(const uint8_t* data, uint16_t length) {
+            uint32_t h = 2166136261UL;
+            for (uint16_t i = 0; i + 4 <= length; i += 4) {
+                uint32_t word;
+                memcpy(&word, data + i, 4);
+                h = (h ^ word) * 16777619UL;
+            }
+            return h;
+        }
+
+        /**
+         * Returns the slot of the source, a new source gets a free slot which is activated by `endPacket`.
+         */
+        Source* findSource(uint32_t ip, unsigned long now) {
+            for (auto& source : sources) {
+                if (source.active && now - source.lastSeenAt > sourceTimeoutMillis) {
+                    Log.noticeln("DMX source %s timed out.", IPAddress(source.ip).toString().c_str());
+                    source.active = false;
+                }
+            }
+            Source* free = nullptr;
+            for (auto& source : sources) {
+                if (source.ip == ip && source.data != nullptr) {
+                    return &source;
+                }
+                // prefer slots with already allocated data
+                if (!source.active && (free == nullptr || (free->data == nullptr && source.data != nullptr))) {
+                    free = &source;
+                }
+            }
+            if (free == nullptr) {
+                return nullptr;
+            }
+            if (free->data == nullptr) {
+                free->data = new uint8_t[assembler->length()]();
+                free->lastSequences = new uint8_t[assembler->getNumUniverses()]();
+                free->hashes = new uint32_t[assembler->getNumUniverses()]();
+            } else {
+                memset(free->data, 0, assembler->length());
+                memset(free->lastSequences, 0, assembler->getNumUniverses());
+                memset(free->hashes, 0, assembler->getNumUniverses() * sizeof(uint32_t));
+            }
+            free->ip = ip;
+            free->packets = 0;
+            free->droppedPackets = 0;
+            free->lostPackets = 0;
+            return free;
+        }
+
+        /**
+         * Keeps the lead, or makes the source active for the longest time the lead once the lead is gone.
+         */
+        void updateLead() {
+            if (lead != nullptr && lead->active) {
+                return;
+            }
+            lead = nullptr;
+            leadMask = 0;
+            for (auto& source : sources) {
+                if (source.active && (lead == nullptr || (long) (source.activeSince - lead->activeSince) < 0)) {
+                    lead = &source;
+                }
+            }
+        }
+
+        /**
+         * `fallback` is used by LTP if the source which changed the universe last is gone.
+         */
+        void mergeUniverse(uint16_t universeIndex, uint8_t* target, Source* fallback) {
+            uint16_t offset = universeIndex * DmxFrameAssembler::UNIVERSE_SIZE;
+            if (mode == LTP) {
+                Source* latest = &sources[ltpSources[universeIndex]];
+                if (!latest->active) {
+                    latest = fallback;
+                }
+                memcpy(target, latest->data + offset, DmxFrameAssembler::UNIVERSE_SIZE);
+                return;
+            }
+            bool first = true;
+            for (auto& source : sources) {
+                if (!source.active) {
+                    continue;
+                }
+                const uint8_t* data = source.data + offset;
+                if (first) {
+                    memcpy(target, data, DmxFrameAssembler::UNIVERSE_SIZE);
+                    first = false;
+                } else {
+                    for (uint16_t i = 0; i < DmxFrameAssembler::UNIVERSE_SIZE; i++) {
+                        if (data[i] > target[i]) {
+                            target[i] = data[i];
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * Merges all the universes into the assembler, which publishes them as one frame.
+         */
+        void commitFrame() {
+            leadMask = 0;
+            pending = false;
+            if (lead == nullptr) {
+                return;
+            }
+            for (uint8_t i = 0; i < assembler->getNumUniverses(); i++) {
+                uint16_t universe = assembler->getFirstUniverse() + i;
+                mergeUniverse(i, assembler->beginUniverse(universe), lead);
+                assembler->endUniverse(universe, DmxFrameAssembler::UNIVERSE_SIZE);
+            }
+        }
+
+    public:
+        DmxMerger(DmxFrameAssembler* assembler, Mode mode = HTP, unsigned long sourceTimeoutMillis = 10000):
+                assembler(assembler),
+                mode(mode),
+                sourceTimeoutMillis(sourceTimeoutMillis) {
+            ltpSources = new uint8_t[assembler->getNumUniverses()]();
+            completeMask = assembler->getNumUniverses() == 32 ? UINT32_MAX : (1UL << assembler->getNumUniverses()) - 1;
+        }
+
+        ~DmxMerger() {
+            for (auto& source : sources) {
+                delete[] source.data;
+                delete[] source.lastSequences;
+                delete[] source.hashes;
+            }
+            delete[] ltpSources;
+        }
+
+        /**
+         * Returns the 512 bytes buffer the universe data of the packet have to be written to,
+         * or nullptr if the packet is dropped. `sequence` 0 disables the sequence tracking.
+         */
+        uint8_t* beginPacket(uint32_t ip, uint16_t universe, uint8_t sequence) {
+            packetSource = nullptr;
+            if (!assembler->accepts(universe)) {
+                return nullptr;
+            }
+            unsigned long now = millis();
+            Source* source = findSource(ip, now);
+            if (source == nullptr) {
+                rejectedPackets++;
+                return nullptr;
+            }
+            uint16_t universeIndex = universe - assembler->getFirstUniverse();
+            // the sequence tracking starts over when the source becomes active
+            uint8_t lastSequence = source->active ? source->lastSequences[universeIndex] : 0;
+            // ignore old sequences of this source unless the counter flipped
+            uint8_t behind = lastSequence - sequence;
+            if (sequence != 0 && lastSequence != 0 && behind > 0 && behind < 64) {
+                Log.traceln("Ignoring old sequence %d, last sequence: %d", sequence, lastSequence);
+                source->droppedPackets++;
+                return nullptr;
+            }
+
+            updateLead();
+            if (source == lead && (leadMask & (1UL << universeIndex))) {
+                // the lead started the next frame, a universe of the current one was lost,
+                // commit before the copy of the source is overwritten
+                commitFrame();
+            }
+            packetSource = source;
+            packetUniverse = universe;
+            packetSequence = sequence;
+            return source->data + universeIndex * DmxFrameAssembler::UNIVERSE_SIZE;
+        }
+
+        /**
+         * Merges the universe of the packet, `length` bytes were written to the buffer returned by `beginPacket`.
+         * Not called if the packet could not be received, the packet is then ignored.
+         */
+        void endPacket(uint16_t length) {
+            if (packetSource == nullptr) {
+                return;
+            }
+            Source* source = packetSource;
+            packetSource = nullptr;
+            uint16_t universeIndex = packetUniverse - assembler->getFirstUniverse();
+            unsigned long now = millis();
+            if (!source->active) {
+                Log.noticeln("DMX source %s active.", IPAddress(source->ip).toString().c_str());
+                source->active = true;
+                source->activeSince = now;
+                memset(source->lastSequences, 0, assembler->getNumUniverses());
+                updateLead();
+            }
+            source->lastSeenAt = now;
+            source->packets++;
+            uint8_t lastSequence = source->lastSequences[universeIndex];
+            if (packetSequence != 0 && lastSequence != 0) {
+                // sequence runs 1..255, 0 is skipped when it flips
+                uint8_t ahead = packetSequence - lastSequence - (packetSequence < lastSequence ? 1 : 0);
+                if (ahead > 1) {
+                    source->lostPackets += ahead - 1;
+                }
+            }
+            source->lastSequences[universeIndex] = packetSequence;
+            if (length < DmxFrameAssembler::UNIVERSE_SIZE) {
+                memset(source->data + universeIndex * DmxFrameAssembler::UNIVERSE_SIZE + length, 0, DmxFrameAssembler::UNIVERSE_SIZE - length);
+            }
+            if (mode == LTP) {
+                uint32_t h = hash(source->data + universeIndex * DmxFrameAssembler::UNIVERSE_SIZE, DmxFrameAssembler::UNIVERSE_SIZE);
+                if (h != source->hashes[universeIndex]) {
+                    source->hashes[universeIndex] = h;
+                    ltpSources[universeIndex] = source - sources;
+                }
+            }
+
+            if (!pending) {
+                pending = true;
+                pendingSince = millis();
+            }
+            if (source == lead) {
+                leadMask |= 1UL << universeIndex;
+                if (leadMask == completeMask) {
+                    commitFrame();
+                }
+            }
+        }
+
+        /**
+         * Commits the frame if the assembler timeout expired since the first packet of the frame,
+         * eg. the lead lost a universe. Call it regularly from the receiving side.
+         */
+        void poll() {
+            if (pending && millis() - pendingSince > assembler->getTimeout()) {
+                commitFrame();
+            }
+        }
+
+        /**
+         * Commits the frame right away (eg. on sync). Call it from the receiving side.
+         */
+        void flush() {
+            if (pending) {
+                commitFrame();
+            }
+        }
+
+        std::vector<SourceStats> getSourceStats() {
+            std::vector<SourceStats> stats;
+            for (auto& source : sources) {
+                if (source.data != nullptr) {
+                    stats.push_back({source.ip, source.packets, source.droppedPackets, source.lostPackets, source.active});
+                }
+            }
+            return stats;
+        }
+
+        Mode getMode() {
+            return mode;
+        }
+
+        /**
+         * Packets dropped because all the source slots were taken by active sources.
+         */
+        uint32_t getRejectedPackets() {
+            return rejectedPackets;
+        }
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <Preferences.h>
+#include <vector>
+
+/**
+ * Persisted DMX state (the last look) with a RAM shadow of the stored data.
+ *
+ * Stores are compared against the shadow, no flash read is needed. The render path marks the state changed when a frame
+ * updated the things, so the periodic autosave answers "no change" without comparing the data (see `isChanged`). Only the changed channel ranges are appended
+ * to a journal, the journal is compacted into the base blob once it grows too big. The number of journal entries
+ * is written after the entries and reset before the compaction, so a power loss leaves an older consistent state.
+ *
+ * NVS keys of the "dmx-state" namespace: "data" base blob, "j<n>" journal entries (2 bytes offset + data),
+ * "jn" number of journal entries.
+ */
+class DmxStateStore {
+    public:
+        static const uint8_t MAX_JOURNAL_ENTRIES = 16;
+        static const uint16_t MAX_JOURNAL_BYTES = 128; // bigger changes are written to the base blob right away
+        static const uint8_t RANGE_GAP = 8; // changed ranges closer than this are joined
+
+    private:
+        struct Range {
+            uint16_t offset;
+            uint16_t length;
+        };
+
+        Preferences preferences;
+        uint16_t length;
+        uint8_t* shadow;
+        uint8_t journalEntries = 0;
+        uint32_t writes = 0;
+        // the state changed since the last store
+        bool changed = true;
+
+        static String journalKey(uint8_t index) {
+            return String("j") + index;
+        }
+
+        std::vector<Range> changedRanges(const uint8_t* data) {
+            std::vector<Range> ranges;
+            uint16_t i = 0;
+            while (i < length) {
+                if (data[i] == shadow[i]) {
+                    i++;
+                    continue;
+                }
+                uint16_t start = i;
+                uint16_t end = i + 1;
+                for (i = end; i < length && i - end < RANGE_GAP; i++) {
+                    if (data[i] != shadow[i]) {
+                        end = i + 1;
+                    }
+                }
+                ranges.push_back({start, (uint16_t) (end - start)});
+                i = end;
+            }
+            return ranges;
+        }
+
+        void compact(const uint8_t* data) {
+            // drop the journal first, a power loss in between leaves the older (consistent) base blob
+            preferences.putUChar("jn", 0);
+            preferences.putBytes("data", data, length);
+            for (uint8_t i = 0; i < journalEntries; i++) {
+                preferences.remove(journalKey(i).c_str());
+            }
+            journalEntries = 0;
+            Log.infoln("DMX state journal compacted.");
+        }
+
+    public:
+        DmxStateStore(uint16_t length):
+                length(length) {
+            shadow = new uint8_t[length]();
+        }
+
+        ~DmxStateStore() {
+            delete[] shadow;
+        }
+
+        /**
+         * Loads the stored state into the shadow.
+         * Data stored with a different channel space size (number of universes) is restored partially.
+         */
+        void load() {
+            memset(shadow, 0, length);
+            preferences.begin("dmx-state", true);
+            size_t storedLength = preferences.getBytesLength("data");
+            if (storedLength > length) {
+                uint8_t* storedData = new uint8_t[storedLength];
+                preferences.getBytes("data", storedData, storedLength);
+                memcpy(shadow, storedData, length);
+                delete[] storedData;
+            } else {
+                preferences.getBytes("data", shadow, length);
+            }
+
+            journalEntries = preferences.getUChar("jn", 0);
+            uint8_t entry[2 + MAX_JOURNAL_BYTES];
+            for (uint8_t i = 0; i < journalEntries; i++) {
+                size_t entryLength = preferences.getBytes(journalKey(i).c_str(), entry, sizeof(entry));
+                uint16_t offset = entry[0] | (entry[1] << 8);
+                if (entryLength < 2 || offset >= length) {
+                    continue;
+                }
+                uint16_t dataLength = entryLength - 2;
+                memcpy(shadow + offset, entry + 2, offset + dataLength > length ? length - offset : dataLength);
+            }
+            preferences.end();
+        }
+
+        /**
+         * Copies the stored state into `data`.
+         */
+        void restore(uint8_t* data) {
+            memcpy(data, shadow, length);
+        }
+
+        /**
+         * Stored state, no flash read.
+         */
+        const uint8_t* getShadow() {
+            return shadow;
+        }
+
+        /**
+         * Call when the state changed, eg. a frame updated the things.
+         */
+        void markChanged() {
+            changed = true;
+        }
+
+        /**
+         * Returns true if the state changed since the last store.
+         */
+        bool isChanged() {
+            return changed;
+        }
+
+        /**
+         * Stores the state, returns false if it is the same as the stored one.
+         */
+        bool store(const uint8_t* data) {
+            changed = false;
+            if (memcmp(data, shadow, length) == 0) {
+                return false;
+            }
+            std::vector<Range> ranges = changedRanges(data);
+            uint16_t journalBytes = 0;
+            for (auto& range : ranges) {
+                journalBytes += range.length;
+            }
+
+            preferences.begin("dmx-state", false);
+            if (journalEntries + ranges.size() > MAX_JOURNAL_ENTRIES || journalBytes > MAX_JOURNAL_BYTES) {
+                compact(data);
+            } else {
+                uint8_t entry[2 + MAX_JOURNAL_BYTES];
+                for (auto& range : ranges) {
+                    entry[0] = range.offset & 0xFF;
+                    entry[1] = range.offset >> 8;
+                    memcpy(entry + 2, data + range.offset, range.length);
+                    preferences.putBytes(journalKey(journalEntries).c_str(), entry, 2 + range.length);
+                    journalEntries++;
+                }
+                preferences.putUChar("jn", journalEntries);
+            }
+            memcpy(shadow, data, length);
+            preferences.end();
+            writes++;
+            Log.infoln("DMX data stored, %d changed range(s).", ranges.size());
+            return true;
+        }
+
+        /**
+         * Number of stores written to the flash since boot.
+         */
+        uint32_t getWrites() {
+            return writes;
+        }
+
+        uint8_t getJournalEntries() {
+            return journalEntries;
+        }
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <atomic>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * Decides when the render side dispatches the newest frame and latches the outputs.
+ *
+ * FREE renders every `FREE_RUN_PERIOD_MS` regardless of received frames (legacy behavior).
+ * ON_FRAME renders as soon as a new frame is published, at most `fps` times per second. Without new frames it
+ * falls back to the free-run period, so animations keep running.
+ * FIXED renders at a constant `fps` cadence driven by esp_timer. Each tick notifies the render task set by
+ * `setRenderTask`, so the cadence doesn't depend on the loop. Without a render task the loop polls the tick.
+ *
+ * Packet-to-latch latency (frame published → outputs committed) is measured for rendered frames.
+ */
+class FramePacer {
+    public:
+        enum Mode {
+            FREE,
+            ON_FRAME,
+            FIXED
+        };
+
+        static const unsigned long FREE_RUN_PERIOD_MS = 20;
+
+    private:
+        Mode mode;
+        uint8_t fps;
+        unsigned long minPeriodMicros;
+        unsigned long lastRenderAt = 0;
+        esp_timer_handle_t timer = nullptr;
+        // set by the timer task, cleared by the render side
+        std::atomic<bool> tick{false};
+        std::atomic<TaskHandle_t> renderTask{nullptr};
+
+        uint32_t latencyCount = 0;
+        uint64_t latencySum = 0;
+        uint32_t maxLatency = 0;
+
+        static void onTimer(void* arg) {
+            FramePacer* pacer = (FramePacer*) arg;
+            pacer->tick.store(true, std::memory_order_release);
+            // the callback runs in the esp_timer task, not in an ISR
+            TaskHandle_t task = pacer->renderTask.load(std::memory_order_acquire);
+            if (task != nullptr) {
+                xTaskNotifyGive(task);
+            }
+        }
+
+    public:
+        FramePacer(Mode mode, uint8_t fps = 44):
+                mode(mode),
+                fps(fps == 0 ? 44 : fps) {
+            minPeriodMicros = 1000000UL / this->fps;
+            if (mode != FIXED) {
+                return;
+            }
+            esp_timer_create_args_t args = {};
+            args.callback = onTimer;
+            args.arg = this;
+            args.name = "frame-pacer";
+            if (esp_timer_create(&args, &timer) != ESP_OK || esp_timer_start_periodic(timer, minPeriodMicros) != ESP_OK) {
+                Log.errorln("Frame pacer timer could not be started, falling back to free-run.");
+                this->mode = FREE;
+            }
+        }
+
+        ~FramePacer() {
+            if (timer != nullptr) {
+                esp_timer_stop(timer);
+                esp_timer_delete(timer);
+            }
+        }
+
+        /**
+         * Task woken on each FIXED tick, it calls `shouldRender` once woken.
+         */
+        void setRenderTask(TaskHandle_t task) {
+            renderTask.store(task, std::memory_order_release);
+        }
+
+        /**
+         * Returns true if the frame should be rendered now. `newFrame` is true if a new frame was published.
+         */
+        bool shouldRender(bool newFrame) {
+            unsigned long now = micros();
+            switch (mode) {
+                case FIXED:
+                    return tick.exchange(false, std::memory_order_acquire);
+                case ON_FRAME:
+                    if (newFrame && now - lastRenderAt >= minPeriodMicros) {
+                        return true;
+                    }
+                    // fall through to keep the free-run cadence without frames
+                default:
+                    return now - lastRenderAt > FREE_RUN_PERIOD_MS * 1000;
+            }
+        }
+
+        /**
+         * Call once the outputs were latched. `framePublishedAt` is micros() of the rendered frame publishing,
+         * 0 if no new frame was rendered.
+         */
+        void rendered(uint32_t framePublishedAt) {
+            lastRenderAt = micros();
+            if (framePublishedAt == 0) {
+                return;
+            }
+            uint32_t latency = lastRenderAt - framePublishedAt;
+            latencyCount++;
+            latencySum += latency;
+            if (latency > maxLatency) {
+                maxLatency = latency;
+            }
+        }
+
+        Mode getMode() {
+            return mode;
+        }
+
+        uint8_t getFps() {
+            return fps;
+        }
+
+        /**
+         * Average packet-to-latch latency in micro seconds since the last reset.
+         */
+        uint32_t getAvgLatency() {
+            return latencyCount > 0 ? latencySum / latencyCount : 0;
+        }
+
+        uint32_t getMaxLatency() {
+            return maxLatency;
+        }
+
+        void resetLatency() {
+            latencyCount = 0;
+            latencySum = 0;
+            maxLatency = 0;
+        }
+};
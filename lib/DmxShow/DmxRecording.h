@@ -0,0 +1,326 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <FS.h>
+
+/**
+ * Recording of the DMX frame stream on a file system (LittleFS).
+ *
+ * File format, all the numbers are little endian, varint is LEB128 (7 bits per byte, low bits first):
+ * - header: "NPDR", version (1 byte), frame length (2 bytes)
+ * - records: time since the previous record in ms (varint), number of runs (varint),
+ *   runs: channels skipped since the end of the previous run (varint), run length (varint), channel values
+ *
+ * The 1st record is a diff against a zeroed frame. Frames without a change are not recorded, a record without runs
+ * marks the end of the recording (keeps the trailing time for looping).
+ */
+class DmxRecording {
+    public:
+        static const uint8_t VERSION = 1;
+        static const uint8_t HEADER_SIZE = 7;
+        // runs closer than this are joined, a new run costs at least 2 bytes
+        static const uint8_t RUN_GAP = 3;
+
+        static size_t writeVarint(uint8_t* buffer, uint32_t value) {
+            size_t i = 0;
+            do {
+                uint8_t b = value & 0x7F;
+                value >>= 7;
+                buffer[i++] = value ? (b | 0x80) : b;
+            } while (value);
+            return i;
+        }
+
+        static bool readVarint(File& file, uint32_t& value) {
+            value = 0;
+            for (uint8_t shift = 0; shift < 35; shift += 7) {
+                int b = file.read();
+                if (b < 0) {
+                    return false;
+                }
+                value |= (uint32_t) (b & 0x7F) << shift;
+                if (!(b & 0x80)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+};
+
+/**
+ * Records the frames into a file, see `DmxRecording`. Keeps a copy of the last recorded frame only.
+ */
+class DmxRecorder {
+    private:
+        File file;
+        uint16_t length;
+        uint8_t* lastFrame;
+        bool recording = false;
+        // micros() of the last record, advanced by the recorded (ms) time only to not accumulate rounding errors
+        uint32_t lastRecordAt = 0;
+        uint32_t records = 0;
+        size_t maxBytes = 0;
+        size_t bytes = 0;
+
+        uint32_t elapsedMillis(uint32_t time) {
+            if (records == 0) {
+                lastRecordAt = time;
+                return 0;
+            }
+            uint32_t elapsed = (time - lastRecordAt) / 1000;
+            lastRecordAt += elapsed * 1000;
+            return elapsed;
+        }
+
+        void writeVarint(uint32_t value) {
+            uint8_t buffer[5];
+            bytes += file.write(buffer, DmxRecording::writeVarint(buffer, value));
+        }
+
+    public:
+        DmxRecorder(uint16_t length):
+                length(length) {
+            lastFrame = new uint8_t[length];
+        }
+
+        ~DmxRecorder() {
+            stop();
+            delete[] lastFrame;
+        }
+
+        /**
+         * The recording stops once the file reaches `maxBytes`.
+         */
+        bool start(fs::FS& fs, const char* path, size_t maxBytes) {
+            stop();
+            file = fs.open(path, FILE_WRITE);
+            if (!file) {
+                Log.errorln("Recording file %s could not be opened.", path);
+                return false;
+            }
+            uint8_t header[DmxRecording::HEADER_SIZE] = {'N', 'P', 'D', 'R', DmxRecording::VERSION, (uint8_t) (length & 0xFF), (uint8_t) (length >> 8)};
+            bytes = file.write(header, DmxRecording::HEADER_SIZE);
+            memset(lastFrame, 0, length);
+            this->maxBytes = maxBytes;
+            records = 0;
+            recording = true;
+            Log.noticeln("DMX recording to %s started.", path);
+            return true;
+        }
+
+        /**
+         * Records the frame if it changed, `time` is micros() of the frame receiving.
+         */
+        void record(const uint8_t* frame, uint32_t time) {
+            if (!recording) {
+                return;
+            }
+            // count the runs first, the count precedes them
+            uint16_t runs = 0;
+            for (uint16_t i = 0; i < length; ) {
+                if (frame[i] == lastFrame[i]) {
+                    i++;
+                    continue;
+                }
+                uint16_t end = i + 1;
+                for (uint16_t j = end; j < length && j - end < DmxRecording::RUN_GAP; j++) {
+                    if (frame[j] != lastFrame[j]) {
+                        end = j + 1;
+                    }
+                }
+                runs++;
+                i = end;
+            }
+            if (runs == 0) {
+                return;
+            }
+            if (bytes + length + 32 > maxBytes) {
+                Log.warningln("DMX recording reached the size limit.");
+                stop();
+                return;
+            }
+
+            writeVarint(elapsedMillis(time));
+            writeVarint(runs);
+            uint16_t runEnd = 0;
+            for (uint16_t i = 0; i < length; ) {
+                if (frame[i] == lastFrame[i]) {
+                    i++;
+                    continue;
+                }
+                uint16_t end = i + 1;
+                for (uint16_t j = end; j < length && j - end < DmxRecording::RUN_GAP; j++) {
+                    if (frame[j] != lastFrame[j]) {
+                        end = j + 1;
+                    }
+                }
+                writeVarint(i - runEnd);
+                writeVarint(end - i);
+                bytes += file.write(frame + i, end - i);
+                runEnd = end;
+                i = end;
+            }
+            memcpy(lastFrame, frame, length);
+            records++;
+        }
+
+        /**
+         * Writes the end record and closes the file.
+         */
+        void stop() {
+            if (!recording) {
+                return;
+            }
+            recording = false;
+            writeVarint(elapsedMillis(micros()));
+            writeVarint(0);
+            Log.noticeln("DMX recording stopped, %d records, %d bytes.", records, bytes);
+            file.close();
+        }
+
+        bool isRecording() {
+            return recording;
+        }
+
+        uint32_t getRecords() {
+            return records;
+        }
+};
+
+/**
+ * Plays a recording back with the recorded timing, optionally in a loop, see `DmxRecording`.
+ * The file is read incrementally, RAM use is one frame.
+ */
+class DmxPlayer {
+    private:
+        File file;
+        uint16_t length;
+        uint8_t* frame;
+        bool playing = false;
+        bool loop = false;
+        unsigned long startedAt = 0;
+        // time of the next record since `startedAt`
+        unsigned long nextRecordAt = 0;
+
+        bool readNextTime() {
+            uint32_t delta;
+            if (!DmxRecording::readVarint(file, delta)) {
+                return false;
+            }
+            nextRecordAt += delta;
+            return true;
+        }
+
+        /**
+         * Applies the runs of the record whose time was read already. Returns false at the end of the recording.
+         * Runs of a recording with more channels are clamped to the played channels.
+         */
+        bool applyRecord() {
+            uint32_t runs;
+            if (!DmxRecording::readVarint(file, runs) || runs == 0) {
+                return false;
+            }
+            uint32_t position = 0;
+            for (uint32_t i = 0; i < runs; i++) {
+                uint32_t skip;
+                uint32_t runLength;
+                if (!DmxRecording::readVarint(file, skip) || !DmxRecording::readVarint(file, runLength)) {
+                    return false;
+                }
+                position += skip;
+                uint32_t played = position >= length ? 0 : (runLength < length - position ? runLength : length - position);
+                if (file.read(frame + position, played) != played
+                        || (runLength > played && !file.seek(runLength - played, SeekCur))) {
+                    Log.errorln("Truncated DMX recording.");
+                    return false;
+                }
+                position += runLength;
+            }
+            return true;
+        }
+
+        void rewind(unsigned long at) {
+            file.seek(DmxRecording::HEADER_SIZE);
+            memset(frame, 0, length);
+            nextRecordAt = 0;
+            startedAt = at;
+        }
+
+    public:
+        DmxPlayer(uint16_t length):
+                length(length) {
+            frame = new uint8_t[length]();
+        }
+
+        ~DmxPlayer() {
+            stop();
+            delete[] frame;
+        }
+
+        bool start(fs::FS& fs, const char* path, bool loop) {
+            stop();
+            file = fs.open(path, FILE_READ);
+            uint8_t header[DmxRecording::HEADER_SIZE];
+            if (!file || file.read(header, DmxRecording::HEADER_SIZE) != DmxRecording::HEADER_SIZE
+                    || memcmp(header, "NPDR", 4) != 0 || header[4] != DmxRecording::VERSION) {
+                Log.errorln("DMX recording %s could not be opened.", path);
+                file.close();
+                return false;
+            }
+            uint16_t recordedLength = header[5] | (header[6] << 8);
+            if (recordedLength != length) {
+                Log.warningln("DMX recording has %d channels, playing %d, the rest is skipped or zeroed.", recordedLength, length);
+            }
+            this->loop = loop;
+            rewind(millis());
+            playing = readNextTime();
+            Log.noticeln("DMX playback of %s started.", path);
+            return playing;
+        }
+
+        void stop() {
+            if (file) {
+                file.close();
+            }
+            playing = false;
+        }
+
+        /**
+         * Returns true if the next record is due.
+         */
+        bool isFrameDue() {
+            return playing && millis() - startedAt >= nextRecordAt;
+        }
+
+        /**
+         * Applies all the due records and copies the played frame into `data`. Returns false if the playback stopped.
+         */
+        bool read(uint8_t* data) {
+            if (!playing) {
+                return false;
+            }
+            bool rewound = false;
+            while (isFrameDue()) {
+                if (applyRecord() && readNextTime()) {
+                    continue;
+                }
+                if (!loop || rewound) {
+                    Log.noticeln("DMX playback finished.");
+                    stop();
+                    break;
+                }
+                // the next loop starts when the recording ended, keeps the loop period exact
+                rewind(startedAt + nextRecordAt);
+                rewound = true;
+                readNextTime();
+            }
+            // network frames might have overwritten the data
+            memcpy(data, frame, length);
+            return playing;
+        }
+
+        bool isPlaying() {
+            return playing;
+        }
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <FS.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * Named scenes (whole DMX frames) stored on a file system (LittleFS) as `/<name>.scene`, recalled with a crossfade.
+ *
+ * A recall only loads the scene, the fade starts from the current frame at the next `blend` (render) call.
+ * Frames are blended 4 channels at a time with 8 bit fixed point weights.
+ */
+class DmxScenes {
+    public:
+        static constexpr const char* EXTENSION = ".scene";
+
+    private:
+        fs::FS& fs;
+        uint16_t length;
+        uint8_t* from;
+        uint8_t* to;
+        std::atomic<bool> pending{false};
+        bool fading = false;
+        unsigned long fadeStartedAt = 0;
+        uint32_t fadeMillis = 0;
+
+        static String path(const String& name) {
+            return String("/") + name + EXTENSION;
+        }
+
+    public:
+        DmxScenes(fs::FS& fs, uint16_t length):
+                fs(fs),
+                length(length) {
+            from = new uint8_t[length]();
+            to = new uint8_t[length]();
+        }
+
+        ~DmxScenes() {
+            delete[] from;
+            delete[] to;
+        }
+
+        /**
+         * Blends `a` and `b` into `out`, `weight` of `b` is 0 - 256. SWAR: the even and odd channels of a 32 bit word
+         * are computed in 16 bit lanes, 255 * 256 fits a lane.
+         */
+        static void crossfade(const uint8_t* a, const uint8_t* b, uint8_t* out, uint16_t length, uint16_t weight) {
+            const uint32_t mask = 0x00FF00FF;
+            uint32_t inverse = 256 - weight;
+            uint16_t words = length / 4;
+            for (uint16_t i = 0; i < words; i++) {
+                uint32_t wa, wb;
+                memcpy(&wa, a + i * 4, 4);
+                memcpy(&wb, b + i * 4, 4);
+                uint32_t even = (((wa & mask) * inverse + (wb & mask) * weight) >> 8) & mask;
+                uint32_t odd = (((wa >> 8) & mask) * inverse + ((wb >> 8) & mask) * weight) & ~mask;
+                uint32_t result = even | odd;
+                memcpy(out + i * 4, &result, 4);
+            }
+            for (uint16_t i = words * 4; i < length; i++) {
+                out[i] = (a[i] * inverse + b[i] * weight) >> 8;
+            }
+        }
+
+        bool save(const String& name, const uint8_t* data) {
+            File file = fs.open(path(name), FILE_WRITE);
+            if (!file) {
+                Log.errorln("Scene %s could not be saved.", name.c_str());
+                return false;
+            }
+            bool written = file.write(data, length) == length;
+            file.close();
+            Log.noticeln("Scene %s saved.", name.c_str());
+            return written;
+        }
+
+        bool remove(const String& name) {
+            return fs.remove(path(name));
+        }
+
+        std::vector<String> list() {
+            std::vector<String> names;
+            File root = fs.open("/");
+            if (!root) {
+                return names;
+            }
+            for (File file = root.openNextFile(); file; file = root.openNextFile()) {
+                String name = file.name();
+                if (name.endsWith(EXTENSION)) {
+                    names.push_back(name.substring(name.lastIndexOf('/') + 1, name.length() - strlen(EXTENSION)));
+                }
+            }
+            return names;
+        }
+
+        /**
+         * Loads the scene and fades to it in `fadeMillis` starting with the next `blend`.
+         * Scenes saved with a different channel space size (number of universes) are recalled partially.
+         */
+        bool recall(const String& name, uint32_t fadeMillis) {
+            File file = fs.open(path(name), FILE_READ);
+            if (!file) {
+                Log.errorln("Scene %s not found.", name.c_str());
+                return false;
+            }
+            memset(to, 0, length);
+            file.read(to, length);
+            file.close();
+            this->fadeMillis = fadeMillis;
+            pending.store(true, std::memory_order_release);
+            Log.noticeln("Recalling scene %s, fade %d ms.", name.c_str(), fadeMillis);
+            return true;
+        }
+
+        bool isFading() {
+            return fading || pending.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Writes the current fade step into `data`, the fade starts from `data`.
+         */
+        void blend(uint8_t* data) {
+            if (pending.exchange(false, std::memory_order_acquire)) {
+                memcpy(from, data, length);
+                fadeStartedAt = millis();
+                fading = true;
+            }
+            if (!fading) {
+                return;
+            }
+            unsigned long elapsed = millis() - fadeStartedAt;
+            if (elapsed >= fadeMillis) {
+                memcpy(data, to, length);
+                fading = false;
+                return;
+            }
+            crossfade(from, to, data, length, (elapsed << 8) / fadeMillis);
+        }
+};
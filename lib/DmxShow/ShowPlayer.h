@@ -0,0 +1,284 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <TaskScheduler.h>
+#include <FS.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * Plays a keyframe show file, channel values are interpolated locally so no DMX stream is needed.
+ *
+ * The show file is a text file, one keyframe per line, sorted by time:
+ *
+ *     # time (ms) fade (ms) channel=value ...
+ *     0 0 1-12=0
+ *     5000 2000 1=255 2=128 4-6=255
+ *
+ * Channels are 1 based indexes of the channel space (channel 1 of the 2nd universe is 513). At the keyframe time
+ * the listed channels start fading from their current value to the new value. Lines are read one keyframe ahead,
+ * so the show length is not limited by RAM. Lines longer than `MAX_LINE` are cut.
+ *
+ * The show time is either the internal clock (optionally looping once all the fades ended), or Art-Net TimeCode.
+ * Without timecode the show holds, a timecode going back seeks the show from the start.
+ */
+class ShowPlayer: public Task {
+    public:
+        enum Clock {
+            INTERNAL,
+            TIMECODE
+        };
+
+        static const uint16_t MAX_LINE = 256;
+        static const unsigned long TIMECODE_TIMEOUT_MS = 1000;
+
+    private:
+        struct Fade {
+            uint16_t channel;
+            uint8_t from;
+            uint8_t to;
+            uint32_t startAt;
+            uint32_t duration;
+        };
+
+        File file;
+        uint16_t length;
+        uint8_t* frame;
+        std::vector<Fade> fades;
+        // index + 1 of the running fade of the channel, 0 means none
+        uint16_t* channelFades;
+
+        bool playing = false;
+        bool loop = false;
+        bool changed = false;
+        Clock clock = INTERNAL;
+        unsigned long startedAt = 0;
+        uint32_t showTime = 0;
+
+        // written by the receiving side
+        std::atomic<uint32_t> timecode{0};
+        std::atomic<unsigned long> timecodeAt{0};
+
+        // next keyframe, read ahead
+        bool hasNext = false;
+        uint32_t nextAt = 0;
+        uint32_t nextFade = 0;
+        char line[MAX_LINE];
+        const char* nextValues = nullptr;
+
+        void readNext() {
+            hasNext = false;
+            while (file.available()) {
+                size_t size = file.readBytesUntil('\n', line, MAX_LINE - 1);
+                line[size] = 0;
+                char* end;
+                const char* p = line;
+                while (*p == ' ' || *p == '\t') {
+                    p++;
+                }
+                if (*p == '#' || *p == 0 || *p == '\r') {
+                    continue;
+                }
+                nextAt = strtoul(p, &end, 10);
+                nextFade = strtoul(end, &end, 10);
+                nextValues = end;
+                hasNext = true;
+                return;
+            }
+        }
+
+        void removeFade(uint16_t channel) {
+            uint16_t index = channelFades[channel];
+            if (index == 0) {
+                return;
+            }
+            channelFades[channel] = 0;
+            if (index < fades.size()) {
+                fades[index - 1] = fades.back();
+                channelFades[fades[index - 1].channel] = index;
+            }
+            fades.pop_back();
+        }
+
+        /**
+         * Moves the running fades to `time`, fixed point 16.16 interpolation.
+         */
+        void updateFades(uint32_t time) {
+            for (size_t i = 0; i < fades.size(); ) {
+                Fade& fade = fades[i];
+                uint32_t elapsed = time - fade.startAt;
+                uint8_t value;
+                bool done = elapsed >= fade.duration;
+                if (done) {
+                    value = fade.to;
+                } else {
+                    uint32_t progress = ((uint64_t) elapsed << 16) / fade.duration;
+                    value = fade.from + (((int32_t) fade.to - fade.from) * (int32_t) progress >> 16);
+                }
+                if (frame[fade.channel] != value) {
+                    frame[fade.channel] = value;
+                    changed = true;
+                }
+                if (done) {
+                    removeFade(fade.channel); // swaps in the last fade, don't move on
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        void applyNext() {
+            const char* p = nextValues;
+            char* end;
+            while (*p) {
+                while (*p == ' ' || *p == '\t' || *p == '\r') {
+                    p++;
+                }
+                if (*p == 0) {
+                    break;
+                }
+                uint32_t first = strtoul(p, &end, 10);
+                uint32_t last = first;
+                if (*end == '-') {
+                    last = strtoul(end + 1, &end, 10);
+                }
+                if (*end != '=' || first == 0) {
+                    Log.warningln("Invalid show keyframe at %d ms.", nextAt);
+                    return;
+                }
+                uint8_t value = strtoul(end + 1, &end, 10);
+                for (uint32_t channel = first - 1; channel < last && channel < length; channel++) {
+                    removeFade(channel);
+                    if (nextFade == 0) {
+                        frame[channel] = value;
+                    } else {
+                        fades.push_back({(uint16_t) channel, frame[channel], value, nextAt, nextFade});
+                        channelFades[channel] = fades.size();
+                    }
+                }
+                p = end;
+            }
+            changed = true;
+        }
+
+        void rewind() {
+            file.seek(0);
+            memset(frame, 0, length);
+            memset(channelFades, 0, length * sizeof(uint16_t));
+            fades.clear();
+            showTime = 0;
+            readNext();
+        }
+
+        void advance(uint32_t time) {
+            if (time < showTime) {
+                rewind();
+            }
+            while (hasNext && nextAt <= time) {
+                updateFades(nextAt);
+                applyNext();
+                readNext();
+            }
+            updateFades(time);
+            showTime = time;
+        }
+
+    public:
+        ShowPlayer(Scheduler* aScheduler, uint16_t length, unsigned long interval = 10):
+                length(length),
+                Task(interval, TASK_FOREVER, aScheduler, false) {
+            frame = new uint8_t[length]();
+            channelFades = new uint16_t[length]();
+        }
+
+        ~ShowPlayer() {
+            stop();
+            delete[] frame;
+            delete[] channelFades;
+        }
+
+        bool start(fs::FS& fs, const char* path, Clock clock, bool loop) {
+            stop();
+            file = fs.open(path, FILE_READ);
+            if (!file) {
+                Log.errorln("Show file %s could not be opened.", path);
+                return false;
+            }
+            this->clock = clock;
+            this->loop = loop;
+            rewind();
+            startedAt = millis();
+            playing = true;
+            enable();
+            Log.noticeln("Show %s started, %s clock.", path, clock == TIMECODE ? "timecode" : "internal");
+            return true;
+        }
+
+        void stop() {
+            if (file) {
+                file.close();
+            }
+            playing = false;
+            disable();
+        }
+
+        /**
+         * Art-Net TimeCode in ms, called by the receiving side.
+         */
+        void onTimeCode(uint32_t time) {
+            timecode.store(time, std::memory_order_relaxed);
+            timecodeAt.store(millis(), std::memory_order_release);
+        }
+
+        bool Callback() {
+            if (!playing) {
+                return true;
+            }
+            unsigned long now = millis();
+            if (clock == TIMECODE) {
+                unsigned long receivedAt = timecodeAt.load(std::memory_order_acquire);
+                if (receivedAt == 0 || now - receivedAt > TIMECODE_TIMEOUT_MS) {
+                    return true; // hold
+                }
+                // free-wheel between the timecode frames
+                advance(timecode.load(std::memory_order_relaxed) + (now - receivedAt));
+                return true;
+            }
+            advance(now - startedAt);
+            if (!hasNext && fades.empty()) {
+                if (!loop) {
+                    Log.noticeln("Show finished.");
+                    playing = false;
+                    disable();
+                    return true;
+                }
+                startedAt += showTime;
+                rewind();
+            }
+            return true;
+        }
+
+        /**
+         * Returns true if the show changed the frame since the last `read`.
+         */
+        bool hasNewFrame() {
+            return playing && changed;
+        }
+
+        /**
+         * Copies the show frame into `data`.
+         */
+        void read(uint8_t* data) {
+            memcpy(data, frame, length);
+            changed = false;
+        }
+
+        bool isPlaying() {
+            return playing;
+        }
+
+        uint32_t getShowTime() {
+            return showTime;
+        }
+};
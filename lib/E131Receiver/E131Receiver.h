@@ -0,0 +1,217 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <lwip/sockets.h>
+#include <DmxFrameAssembler.h>
+
+/**
+ * sACN (E1.31) receiver.
+ *
+ * Joins only the multicast groups of the assembled universes (239.255.<universe hi>.<universe lo>), unicast is received as well.
+ * The header is peeked first, DMX data of accepted packets is received straight into the frame assembler buffer.
+ *
+ * Each universe follows the source with the highest priority. A source holding the universe is replaced by a source
+ * with a higher priority, or by any source once it times out or terminates the stream.
+ */
+class E131Receiver {
+    public:
+        static const uint16_t PORT = 5568;
+        static const uint16_t HEADER_SIZE = 126; // root + framing + DMP layer up to (including) the start code
+        static const unsigned long SOURCE_TIMEOUT_MS = 2500; // E1.31 network data loss timeout
+
+    private:
+        static const uint8_t CID_SIZE = 16;
+
+        struct UniverseSource {
+            uint8_t cid[CID_SIZE];
+            uint8_t priority;
+            uint8_t lastSequence;
+            unsigned long lastSeenAt;
+            bool active;
+        };
+
+        DmxFrameAssembler* assembler;
+        UniverseSource* sources;
+        int sock = -1;
+        uint8_t header[HEADER_SIZE];
+
+        uint32_t packets = 0;
+        uint32_t rejectedPackets = 0;
+        uint32_t lostPackets = 0;
+
+        static uint16_t read16(const uint8_t* data) {
+            return (data[0] << 8) | data[1];
+        }
+
+        static uint32_t read32(const uint8_t* data) {
+            return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3];
+        }
+
+        void discard() {
+            recv(sock, header, 1, 0); // UDP drops the rest of the datagram
+            rejectedPackets++;
+        }
+
+        /**
+         * Returns true if the source might update the universe.
+         */
+        bool acceptSource(uint16_t universe, const uint8_t* cid, uint8_t priority, uint8_t sequence, bool terminated) {
+            UniverseSource& current = sources[universe - assembler->getFirstUniverse()];
+            unsigned long now = millis();
+            bool sameSource = current.active && memcmp(current.cid, cid, CID_SIZE) == 0;
+            if (terminated) {
+                if (sameSource) {
+                    Log.noticeln("sACN source terminated universe %d.", universe);
+                    current.active = false;
+                }
+                return false;
+            }
+            if (!sameSource && current.active && now - current.lastSeenAt <= SOURCE_TIMEOUT_MS && priority <= current.priority) {
+                return false;
+            }
+            if (!sameSource) {
+                Log.noticeln("sACN universe %d follows a new source with priority %d.", universe, priority);
+                memcpy(current.cid, cid, CID_SIZE);
+            } else if (now - current.lastSeenAt <= SOURCE_TIMEOUT_MS) {
+                // E1.31 6.7.2, out of order packets are discarded
+                int8_t ahead = sequence - current.lastSequence;
+                if (ahead <= 0 && ahead > -20) {
+                    return false;
+                }
+                if (ahead > 1) {
+                    lostPackets += ahead - 1;
+                }
+            }
+            current.lastSequence = sequence;
+            current.priority = priority;
+            current.lastSeenAt = now;
+            current.active = true;
+            return true;
+        }
+
+    public:
+        E131Receiver(DmxFrameAssembler* assembler):
+                assembler(assembler) {
+            sources = new UniverseSource[assembler->getNumUniverses()]();
+        }
+
+        ~E131Receiver() {
+            end();
+            delete[] sources;
+        }
+
+        /**
+         * Opens the socket and joins the multicast groups, call it once the network is up (again).
+         */
+        bool begin() {
+            end();
+            sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+            if (sock < 0) {
+                Log.errorln("sACN socket could not be created.");
+                return false;
+            }
+            int reuse = 1;
+            setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            struct sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(PORT);
+            addr.sin_addr.s_addr = htonl(INADDR_ANY);
+            if (bind(sock, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+                Log.errorln("sACN socket could not be bound to port %d.", PORT);
+                end();
+                return false;
+            }
+            fcntl(sock, F_SETFL, O_NONBLOCK);
+
+            for (uint16_t universe = assembler->getFirstUniverse(); universe < assembler->getFirstUniverse() + assembler->getNumUniverses(); universe++) {
+                struct ip_mreq mreq = {};
+                mreq.imr_multiaddr.s_addr = htonl(0xEFFF0000 | universe); // 239.255.<hi>.<lo>
+                mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+                if (setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+                    Log.errorln("sACN failed to join multicast group of universe %d.", universe);
+                } else {
+                    Log.noticeln("sACN joined multicast group 239.255.%d.%d.", universe >> 8, universe & 0xFF);
+                }
+            }
+            return true;
+        }
+
+        void end() {
+            if (sock >= 0) {
+                close(sock);
+                sock = -1;
+            }
+        }
+
+        /**
+         * Receives all the pending packets. Returns true if at least one universe was updated.
+         */
+        bool parse() {
+            if (sock < 0) {
+                return false;
+            }
+            bool updated = false;
+            while (true) {
+                int size = recv(sock, header, HEADER_SIZE, MSG_PEEK);
+                if (size < 0) {
+                    break; // EWOULDBLOCK, nothing to read
+                }
+                packets++;
+                if (size < HEADER_SIZE
+                        || read32(header + 18) != 0x00000004 // root layer vector: VECTOR_ROOT_E131_DATA
+                        || read32(header + 40) != 0x00000002 // framing layer vector: VECTOR_E131_DATA_PACKET
+                        || header[117] != 0x02 // DMP layer vector: VECTOR_DMP_SET_PROPERTY
+                        || read16(header + 123) < 1 // property value count, at least the start code
+                        || header[125] != 0x00) { // only the null start code carries dimmer data
+                    discard();
+                    continue;
+                }
+                uint16_t universe = read16(header + 113);
+                uint8_t options = header[112];
+                if (!assembler->accepts(universe)
+                        || (options & 0x80) // preview data
+                        || !acceptSource(universe, header + 22, header[108], header[111], options & 0x40)) {
+                    discard();
+                    continue;
+                }
+                uint16_t length = read16(header + 123) - 1; // property value count includes the start code
+                if (length > DmxFrameAssembler::UNIVERSE_SIZE) {
+                    length = DmxFrameAssembler::UNIVERSE_SIZE;
+                }
+
+                // receive the header again and the DMX data straight into the universe buffer
+                struct iovec iov[2];
+                iov[0].iov_base = header;
+                iov[0].iov_len = HEADER_SIZE;
+                iov[1].iov_base = assembler->beginUniverse(universe);
+                iov[1].iov_len = length;
+                struct msghdr msg = {};
+                msg.msg_iov = iov;
+                msg.msg_iovlen = 2;
+                int received = recvmsg(sock, &msg, 0);
+                if (received < HEADER_SIZE) {
+                    continue;
+                }
+                assembler->endUniverse(universe, received - HEADER_SIZE);
+                updated = true;
+            }
+            return updated;
+        }
+
+        uint32_t getPackets() {
+            return packets;
+        }
+
+        uint32_t getRejectedPackets() {
+            return rejectedPackets;
+        }
+
+        /**
+         * Packets missing in the sequence, dropped by the network or the socket.
+         */
+        uint32_t getLostPackets() {
+            return lostPackets;
+        }
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <functional>
+#include <lwip/sockets.h>
+
+/**
+ * OSC (Open Sound Control) receiver writing into the DMX channel space, e.g. for QLab or TouchOSC faders.
+ *
+ * Addresses:
+ * - `/dmx/<channel>` channel of the channel space, 1 based (channel 1 of the 2nd universe is 513)
+ * - `/<thing name>/<offset>` channel of a thing, offset 0 is the 1st channel of the thing, `/<thing name>` is offset 0
+ *
+ * Float arguments (0.0 - 1.0) are scaled to 0 - 255, int arguments are clamped to 0 - 255, true / false are 255 / 0.
+ * More arguments set the following channels. Bundles are unpacked, time tags are ignored.
+ *
+ * Packets are parsed in place in the receive buffer, no heap allocation.
+ */
+class OscReceiver {
+    public:
+        static const uint16_t MAX_PACKET_SIZE = 1472;
+        static const uint8_t MAX_BUNDLE_DEPTH = 4;
+
+    private:
+        uint16_t port;
+        int sock = -1;
+        uint8_t packet[MAX_PACKET_SIZE];
+        std::function<int(const char*)> channelResolver;
+
+        uint32_t messages = 0;
+        uint32_t rejectedMessages = 0;
+
+        static uint32_t read32(const uint8_t* data) {
+            return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3];
+        }
+
+        /**
+         * Length of the OSC string including the padding, 0 if it is not terminated within `size`.
+         */
+        static int paddedLength(const uint8_t* data, int size) {
+            const uint8_t* end = (const uint8_t*) memchr(data, 0, size);
+            if (end == nullptr) {
+                return 0;
+            }
+            int length = ((end - data) + 4) & ~3;
+            return length <= size ? length : 0;
+        }
+
+        /**
+         * Channel space index of the address, -1 if unknown. The address is split in place.
+         */
+        int resolve(char* address) {
+            if (address[0] != '/') {
+                return -1;
+            }
+            char* name = address + 1;
+            char* separator = strchr(name, '/');
+            long offset = 0;
+            if (separator != nullptr) {
+                *separator = 0;
+                char* end;
+                offset = strtol(separator + 1, &end, 10);
+                if (*end != 0 || offset < 0) {
+                    return -1;
+                }
+            }
+            if (strcmp(name, "dmx") == 0) {
+                return separator != nullptr && offset > 0 ? offset - 1 : -1;
+            }
+            int firstChannel = channelResolver ? channelResolver(name) : -1;
+            return firstChannel >= 0 ? firstChannel + offset : -1;
+        }
+
+        bool parseMessage(uint8_t* message, int size, uint8_t* data, uint16_t length) {
+            messages++;
+            int addressLength = paddedLength(message, size);
+            if (addressLength == 0 || addressLength >= size || message[addressLength] != ',') {
+                rejectedMessages++;
+                return false;
+            }
+            const char* types = (const char*) message + addressLength + 1;
+            int typesLength = paddedLength(message + addressLength, size - addressLength);
+            if (typesLength == 0) {
+                rejectedMessages++;
+                return false;
+            }
+            int channel = resolve((char*) message);
+            if (channel < 0) {
+                rejectedMessages++;
+                return false;
+            }
+
+            const uint8_t* arg = message + addressLength + typesLength;
+            const uint8_t* end = message + size;
+            bool updated = false;
+            for (; *types && channel < length; types++, channel++) {
+                int32_t value;
+                if (*types == 'f' || *types == 'i') {
+                    if (arg + 4 > end) {
+                        break;
+                    }
+                    uint32_t raw = read32(arg);
+                    arg += 4;
+                    if (*types == 'f') {
+                        float f;
+                        memcpy(&f, &raw, 4);
+                        value = f * 255.0f + 0.5f;
+                    } else {
+                        value = (int32_t) raw;
+                    }
+                } else if (*types == 'T' || *types == 'F') {
+                    value = *types == 'T' ? 255 : 0;
+                } else {
+                    break; // other types are not supported, the argument size is unknown
+                }
+                uint8_t channelValue = value < 0 ? 0 : value > 255 ? 255 : value;
+                if (data[channel] != channelValue) {
+                    data[channel] = channelValue;
+                    updated = true;
+                }
+            }
+            return updated;
+        }
+
+        bool parseElement(uint8_t* element, int size, uint8_t* data, uint16_t length, uint8_t depth) {
+            if (size < 8 || memcmp(element, "#bundle", 8) != 0) {
+                return parseMessage(element, size, data, length);
+            }
+            if (depth >= MAX_BUNDLE_DEPTH) {
+                rejectedMessages++;
+                return false;
+            }
+            bool updated = false;
+            int position = 16; // "#bundle" and the time tag
+            while (position + 4 <= size) {
+                uint32_t elementSize = read32(element + position);
+                position += 4;
+                if (elementSize > (uint32_t) (size - position)) {
+                    rejectedMessages++;
+                    break;
+                }
+                updated |= parseElement(element + position, elementSize, data, length, depth + 1);
+                position += elementSize;
+            }
+            return updated;
+        }
+
+    public:
+        OscReceiver(uint16_t port):
+                port(port) {
+        }
+
+        ~OscReceiver() {
+            end();
+        }
+
+        /**
+         * The resolver returns the index of the 1st channel of the thing with the given name, -1 if not found.
+         */
+        void setChannelResolver(std::function<int(const char*)> resolver) {
+            channelResolver = resolver;
+        }
+
+        bool begin() {
+            end();
+            sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+            if (sock < 0) {
+                Log.errorln("OSC socket could not be created.");
+                return false;
+            }
+            int reuse = 1;
+            setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            struct sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(port);
+            addr.sin_addr.s_addr = htonl(INADDR_ANY);
+            if (bind(sock, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+                Log.errorln("OSC socket could not be bound to port %d.", port);
+                end();
+                return false;
+            }
+            fcntl(sock, F_SETFL, O_NONBLOCK);
+            return true;
+        }
+
+        void end() {
+            if (sock >= 0) {
+                close(sock);
+                sock = -1;
+            }
+        }
+
+        /**
+         * Receives all the pending packets into `data` (the channel space). Returns true if a channel changed.
+         */
+        bool parse(uint8_t* data, uint16_t length) {
+            if (sock < 0) {
+                return false;
+            }
+            bool updated = false;
+            while (true) {
+                int size = recv(sock, packet, MAX_PACKET_SIZE, 0);
+                if (size < 0) {
+                    break; // EWOULDBLOCK, nothing to read
+                }
+                updated |= parseElement(packet, size, data, length, 0);
+            }
+            return updated;
+        }
+
+        uint32_t getMessages() {
+            return messages;
+        }
+
+        /**
+         * Malformed messages and messages with unknown addresses.
+         */
+        uint32_t getRejectedMessages() {
+            return rejectedMessages;
+        }
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <NeoPixelBus.h>
+
+/**
+ * Strip of pixels of the color `T_COLOR`, independent of the NeoPixelBus feature (color order) and method (output).
+ * The calls forwarded to NeoPixelBus keep their names.
+ */
+template<typename T_COLOR>
+class PixelStrip {
+    public:
+        virtual ~PixelStrip() {}
+
+        virtual void Begin() = 0;
+        virtual void Show() = 0;
+        virtual bool IsDirty() = 0;
+        virtual void Dirty() = 0;
+        virtual uint16_t PixelCount() = 0;
+        virtual uint8_t* Pixels() = 0;
+        virtual size_t PixelsSize() = 0;
+        virtual size_t PixelSize() = 0;
+        virtual void SetPixelColor(uint16_t index, T_COLOR color) = 0;
+        virtual T_COLOR GetPixelColor(uint16_t index) = 0;
+        virtual void ClearTo(T_COLOR color, uint16_t first, uint16_t last) = 0;
+
+        void ClearTo(T_COLOR color) {
+            ClearTo(color, 0, PixelCount() - 1);
+        }
+
+        /**
+         * Writes the color in the wire format (color order) of the strip into `pixel` (`PixelSize` bytes).
+         */
+        virtual void encode(uint8_t* pixel, T_COLOR color) = 0;
+
+        /**
+         * Strips sent in parallel are latched together, they must all be shown when one of them changed.
+         */
+        virtual bool isParallel() = 0;
+
+        /**
+         * Output used by the strip, e.g. "RMT 2", for the logs.
+         */
+        virtual const String& getOutput() = 0;
+};
+
+template<typename T_COLOR_FEATURE, typename T_METHOD>
+class NeoPixelStrip : public PixelStrip<typename T_COLOR_FEATURE::ColorObject> {
+    private:
+        typedef typename T_COLOR_FEATURE::ColorObject ColorObject;
+
+        bool parallel;
+        String output;
+
+    protected:
+        NeoPixelBus<T_COLOR_FEATURE, T_METHOD> bus;
+
+    public:
+        using PixelStrip<ColorObject>::ClearTo;
+
+        /**
+         * `args` are passed to the NeoPixelBus constructor (pixel count, pin(s), channel).
+         */
+        template<typename... T_ARGS>
+        NeoPixelStrip(const String& output, bool parallel, T_ARGS... args):
+                parallel(parallel),
+                output(output),
+                bus(args...) {
+        }
+
+        void Begin() {
+            bus.Begin();
+        }
+
+        void Show() {
+            bus.Show();
+        }
+
+        bool IsDirty() {
+            return bus.IsDirty();
+        }
+
+        void Dirty() {
+            bus.Dirty();
+        }
+
+        uint16_t PixelCount() {
+            return bus.PixelCount();
+        }
+
+        uint8_t* Pixels() {
+            return bus.Pixels();
+        }
+
+        size_t PixelsSize() {
+            return bus.PixelsSize();
+        }
+
+        size_t PixelSize() {
+            return T_COLOR_FEATURE::PixelSize;
+        }
+
+        void SetPixelColor(uint16_t index, ColorObject color) {
+            bus.SetPixelColor(index, color);
+        }
+
+        ColorObject GetPixelColor(uint16_t index) {
+            return bus.GetPixelColor(index);
+        }
+
+        void ClearTo(ColorObject color, uint16_t first, uint16_t last) {
+            bus.ClearTo(color, first, last);
+        }
+
+        void encode(uint8_t* pixel, ColorObject color) {
+            T_COLOR_FEATURE::applyPixelColor(pixel, 0, color);
+        }
+
+        bool isParallel() {
+            return parallel;
+        }
+
+        const String& getOutput() {
+            return output;
+        }
+};
+
+/**
+ * Strip of a clocked chipset (APA102, SK9822) on the hardware SPI, the pins are assigned at `Begin`.
+ */
+template<typename T_COLOR_FEATURE, typename T_METHOD>
+class SpiPixelStrip : public NeoPixelStrip<T_COLOR_FEATURE, T_METHOD> {
+    private:
+        int8_t clockPin;
+        int8_t dataPin;
+
+    public:
+        SpiPixelStrip(const String& output, uint16_t countPixels, int8_t clockPin, int8_t dataPin):
+                NeoPixelStrip<T_COLOR_FEATURE, T_METHOD>(output, false, countPixels),
+                clockPin(clockPin),
+                dataPin(dataPin) {
+        }
+
+        void Begin() {
+            this->bus.Begin(clockPin, -1, dataPin, -1);
+        }
+};
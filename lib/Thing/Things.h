@@ -4,11 +4,14 @@
 #include <ArduinoLog.h>
 #include <NeoPixelBus.h>
 #include <ESP32Servo.h>
+#include "PixelStrip.h"
 
 class Thing {
     private:
         String name;
     public:
+        virtual ~Thing() {}
+
         virtual int numChannels() = 0;
         virtual void setData(uint8_t* data) = 0;
 
@@ -30,21 +33,74 @@ class Switchabe {
 class SwitchableThing : public Thing, public Switchabe {
 };
 
+/**
+ * Gamma and color correction (white balance) combined into one table per color (R, G, B, W), built once per strip.
+ * The dimmer is applied to the table value as an 8 bit fixed point scale, so slices with different dimmer values
+ * share the table.
+ */
+class ColorLut {
+    public:
+        static const uint8_t COLORS = 4;
+
+    private:
+        uint8_t table[COLORS][256];
+
+    public:
+        /**
+         * Color correction factors are 0 - 255, 255 means no correction.
+         */
+        ColorLut(uint8_t red = 255, uint8_t green = 255, uint8_t blue = 255, uint8_t white = 255) {
+            uint8_t corrections[COLORS] = {red, green, blue, white};
+            for (uint8_t color = 0; color < COLORS; color++) {
+                // 8.8 fixed point factor, 256 means 1.0
+                uint16_t factor = corrections[color] + (corrections[color] >> 7);
+                for (int value = 0; value < 256; value++) {
+                    table[color][value] = (NeoGammaTableMethod::Correct(value) * factor) >> 8;
+                }
+            }
+        }
+
+        /**
+         * Corrected value of the color (0 - 3 for R, G, B, W).
+         */
+        inline uint8_t correct(uint8_t color, uint8_t value) const {
+            return table[color][value];
+        }
+
+        /**
+         * Corrected and dimmed value of the color, `dimm` 255 means full brightness.
+         */
+        inline uint8_t correct(uint8_t color, uint8_t value, uint8_t dimm) const {
+            return (table[color][value] * (dimm + 1)) >> 8;
+        }
+};
+
 template<typename T_COLOR> 
 class SliceThingBase : public SwitchableThing {
     protected:
         int pxFrom;
         int pxTo;
-        static NeoGamma<NeoGammaTableMethod> colorGamma;
+        // shared by the slices of a strip
+        ColorLut* lut;
 
         virtual void doSetColor(uint16_t px, T_COLOR color, uint8_t dimm) = 0;
+        /**
+         * Sets all the pixels of the slice, the color is corrected once.
+         */
+        virtual void doFill(T_COLOR color, uint8_t dimm) = 0;
         boolean dimmable;
 
+        // last color set to the whole slice, invalidated by single pixel updates
+        bool filled = false;
+        T_COLOR lastColor;
+        uint8_t lastDimm;
+
     public:
-        SliceThingBase(int pxFrom, int pxTo, bool dimmable):
+        SliceThingBase(int pxFrom, int pxTo, bool dimmable, ColorLut* lut):
                 dimmable(dimmable), 
                 pxFrom(pxFrom), 
-                pxTo(pxTo) {
+                pxTo(pxTo),
+                lut(lut) {
         }
 
         int size() {
@@ -52,9 +108,13 @@ class SliceThingBase : public SwitchableThing {
         }
 
         void setColor(T_COLOR color, uint8_t dimm = 255) {
-            for (int px = 0; px < size(); px++) {
-                doSetColor(px, color, dimm);
+            if (filled && color == lastColor && dimm == lastDimm) {
+                return;
             }
+            doFill(color, dimm);
+            filled = true;
+            lastColor = color;
+            lastDimm = dimm;
         }
 
         void setColor(uint16_t px, T_COLOR color, uint8_t dimm = 255) {
@@ -62,19 +122,16 @@ class SliceThingBase : public SwitchableThing {
             if (px < 0 || px >= size()) {
                 return;
             }
+            filled = false;
             doSetColor(px, color, dimm);
         }
 
         void on() {
-            for (int px = 0; px < size(); px++) {
-                doSetColor(px, T_COLOR(255), 255);
-            }
+            setColor(T_COLOR(255), 255);
         }
 
         void off() {
-            for (int px = 0; px < size(); px++) {
-                doSetColor(px, T_COLOR(0), 0);
-            }
+            setColor(T_COLOR(0), 0);
         }
 
         boolean isDimmable() {
@@ -159,25 +216,28 @@ class LedThing : public SwitchableThing {
 
 class RgbThing : public SliceThingBase<RgbColor> {
   private:
-    NeoPixelBus<NeoGrbFeature, NeoEsp32RmtNWs2812xMethod>* strip;
+    PixelStrip<RgbColor>* strip;
     
   protected:
     void doSetColor(uint16_t px, RgbColor color, uint8_t dimm) {
         // update only if the color is different
         auto stripPx = pxFrom + px;
-        auto gColor = colorGamma.Correct(color);
-        auto dimmFactor = dimm / 255.0;
-        auto gColorDimm = RgbColor(gColor.R * dimmFactor, gColor.G * dimmFactor, gColor.B * dimmFactor);
+        auto gColorDimm = RgbColor(lut->correct(0, color.R, dimm), lut->correct(1, color.G, dimm), lut->correct(2, color.B, dimm));
         if (strip->GetPixelColor(stripPx) != gColorDimm) {
             //  Log.traceln("Setting pixel %d to %d %d %d, dimm %d", stripPx, gColorDimm.R, gColorDimm.G, gColorDimm.B, dimm);
             strip->SetPixelColor(stripPx, gColorDimm);
         }
     }
 
+    void doFill(RgbColor color, uint8_t dimm) {
+        // the wire format is computed once and replicated over the span
+        strip->ClearTo(RgbColor(lut->correct(0, color.R, dimm), lut->correct(1, color.G, dimm), lut->correct(2, color.B, dimm)), pxFrom, pxTo);
+    }
+
   public:
-        RgbThing(NeoPixelBus<NeoGrbFeature, NeoEsp32RmtNWs2812xMethod>* strip, int pxFrom, int pxTo, bool dimmable):
+        RgbThing(PixelStrip<RgbColor>* strip, int pxFrom, int pxTo, bool dimmable, ColorLut* lut):
                 strip(strip),
-                SliceThingBase<RgbColor>(pxFrom, pxTo, dimmable) {
+                SliceThingBase<RgbColor>(pxFrom, pxTo, dimmable, lut) {
             Log.traceln("RgbThing created. FromPx: %d, ToPx: %d. Dimmable: %d", pxFrom, pxTo, dimmable);
         }
 
@@ -196,26 +256,28 @@ class RgbThing : public SliceThingBase<RgbColor> {
 
 class RgbwThing : public SliceThingBase<RgbwColor> {
     private:
-        NeoPixelBus<NeoGrbwFeature, NeoEsp32RmtNSk6812Method>* strip;
-        static NeoGamma<NeoGammaTableMethod> colorGamma;
+        PixelStrip<RgbwColor>* strip;
 
     protected:
         void doSetColor(uint16_t px, RgbwColor color, uint8_t dimm) {
             // update only if the color is different
             auto stripPx = pxFrom + px;
-            auto gColor = colorGamma.Correct(color);
-            auto dimmFactor = dimm / 255.0;
-            auto gColorDimm = RgbwColor(gColor.R * dimmFactor, gColor.G * dimmFactor, gColor.B * dimmFactor, gColor.W * dimmFactor);
+            auto gColorDimm = RgbwColor(lut->correct(0, color.R, dimm), lut->correct(1, color.G, dimm), lut->correct(2, color.B, dimm), lut->correct(3, color.W, dimm));
             if (strip->GetPixelColor(stripPx) != gColorDimm) {
                 // Log.traceln("Setting pixel %d to %d %d %d %d, w/ dimm %d.", stripPx, gColor.R, gColor.G, gColor.B, gColor.W, dimm);
                 strip->SetPixelColor(stripPx, gColorDimm);
             }
         }
 
+        void doFill(RgbwColor color, uint8_t dimm) {
+            // the wire format is computed once and replicated over the span
+            strip->ClearTo(RgbwColor(lut->correct(0, color.R, dimm), lut->correct(1, color.G, dimm), lut->correct(2, color.B, dimm), lut->correct(3, color.W, dimm)), pxFrom, pxTo);
+        }
+
     public:
-        RgbwThing(NeoPixelBus<NeoGrbwFeature, NeoEsp32RmtNSk6812Method>* strip, int pxFrom, int pxTo, bool dimmable):
+        RgbwThing(PixelStrip<RgbwColor>* strip, int pxFrom, int pxTo, bool dimmable, ColorLut* lut):
                 strip(strip),
-                SliceThingBase<RgbwColor>(pxFrom, pxTo, dimmable) {
+                SliceThingBase<RgbwColor>(pxFrom, pxTo, dimmable, lut) {
             Log.traceln("RgbwThing created. FromPx: %d, ToPx: %d. Dimmable: %d", pxFrom, pxTo, dimmable);
         }
 
@@ -234,6 +296,141 @@ class RgbwThing : public SliceThingBase<RgbwColor> {
         }
 };
 
+/**
+ * Strip whose pixel buffer is written by byte offset, used by the pixel map mode and by DDP.
+ */
+class PixelMapBase : public SwitchableThing {
+    public:
+        /**
+         * Number of bytes of the pixel data (3 or 4 per pixel), the dimmer channel excluded.
+         */
+        virtual uint32_t pixelDataLength() = 0;
+
+        /**
+         * Writes the pixel data in the R, G, B(, W) order starting at the byte `offset`.
+         */
+        virtual void setPixelData(uint32_t offset, const uint8_t* data, uint32_t length) = 0;
+};
+
+/**
+ * Whole strip mapped to a channel range, 3 (RGB) or 4 (RGBW) channels per pixel, optionally followed by a dimmer channel.
+ * Like the pixel mappers of the consoles, a pixel doesn't span two universes: `universeChannels` channels of each
+ * universe are used (510 = 170 RGB pixels by default), the rest of the universe is skipped. Universes are counted from
+ * the 1st channel of the thing, patch it to the 1st address of a universe.
+ * Each universe is copied into the strip buffer in one pass, reordered to the color order of the strip and corrected
+ * (gamma, color correction and dimmer) by the LUT. DDP data is contiguous and written by `setPixelData` directly.
+ */
+template<typename T_COLOR>
+class PixelMapThing : public PixelMapBase {
+    private:
+        static const uint8_t COLORS = T_COLOR::Count;
+        static const uint8_t MAX_PIXEL_SIZE = 8;
+        static const uint16_t UNIVERSE_SIZE = 512;
+
+        PixelStrip<T_COLOR>* strip;
+        bool dimmable;
+        ColorLut* lut;
+        uint8_t dimm = 255;
+        size_t pixelSize;
+        uint16_t universeChannels;
+        // position in the strip buffer pixel of each color (in the R, G, B, W order)
+        uint8_t position[COLORS];
+
+        void fill(uint8_t value) {
+            T_COLOR color;
+            for (uint8_t i = 0; i < COLORS; i++) {
+                color[i] = value;
+            }
+            strip->ClearTo(color);
+        }
+
+    public:
+        /**
+         * `universeChannels` is rounded down to whole pixels, 0 means as many whole pixels as a universe takes.
+         */
+        PixelMapThing(PixelStrip<T_COLOR>* strip, bool dimmable, ColorLut* lut, uint16_t universeChannels = 0):
+                strip(strip),
+                dimmable(dimmable),
+                lut(lut) {
+            if (universeChannels == 0 || universeChannels > UNIVERSE_SIZE) {
+                universeChannels = UNIVERSE_SIZE;
+            }
+            this->universeChannels = universeChannels < COLORS ? COLORS : universeChannels / COLORS * COLORS;
+            pixelSize = strip->PixelSize();
+            // let the strip place the color indexes to find the color order, other bytes of the pixel are left as set
+            T_COLOR color;
+            for (uint8_t i = 0; i < COLORS; i++) {
+                color[i] = i;
+            }
+            uint8_t pixel[MAX_PIXEL_SIZE] = {};
+            strip->encode(pixel, color);
+            for (uint8_t i = 0; i < pixelSize; i++) {
+                if (pixel[i] < COLORS) {
+                    position[pixel[i]] = i;
+                }
+            }
+            fill(0);
+            Log.traceln("PixelMapThing created. Pixels: %d. Dimmable: %d. Universe channels: %d",
+                strip->PixelCount(), dimmable, this->universeChannels);
+        }
+
+        int numChannels() {
+            uint32_t length = pixelDataLength();
+            if (length == 0) {
+                return dimmable ? 1 : 0;
+            }
+            // the dimmer follows the last pixel
+            uint32_t last = length - 1;
+            return last / universeChannels * UNIVERSE_SIZE + last % universeChannels + 1 + (dimmable ? 1 : 0);
+        }
+
+        uint32_t pixelDataLength() {
+            return strip->PixelCount() * COLORS;
+        }
+
+        void setData(uint8_t* data) {
+            if (dimmable) {
+                dimm = data[numChannels() - 1];
+            }
+            uint32_t length = pixelDataLength();
+            for (uint32_t offset = 0; offset < length; offset += universeChannels, data += UNIVERSE_SIZE) {
+                setPixelData(offset, data, universeChannels);
+            }
+        }
+
+        void setPixelData(uint32_t offset, const uint8_t* data, uint32_t length) {
+            if (offset >= pixelDataLength()) {
+                return;
+            }
+            if (offset + length > pixelDataLength()) {
+                length = pixelDataLength() - offset;
+            }
+            uint8_t* pixel = strip->Pixels() + offset / COLORS * pixelSize;
+            uint8_t color = offset % COLORS;
+            uint8_t diff = 0;
+            for (uint32_t i = 0; i < length; i++) {
+                uint8_t value = lut->correct(color, data[i], dimm);
+                diff |= pixel[position[color]] ^ value;
+                pixel[position[color]] = value;
+                if (++color == COLORS) {
+                    color = 0;
+                    pixel += pixelSize;
+                }
+            }
+            if (diff) {
+                strip->Dirty();
+            }
+        }
+
+        void on() {
+            fill(255);
+        }
+
+        void off() {
+            fill(0);
+        }
+};
+
 class ServoThing : public Thing {
     private:
         int currentValue = 0;
@@ -28,7 +28,7 @@ class TailAnimationThing: public Thing {
         }
 
         void setData(uint8_t* data) {
-            // TODO set only if changed
+            // called only if the channels changed, see DmxListener
             tailAnimation->setColor1(RgbColor(data[0], data[1], data[2]));
             tailAnimation->setColor2(RgbColor(data[3], data[4], data[5]));
             tailAnimation->setDuration(data[6]/255.0 * maxDuration);
@@ -6,11 +6,12 @@
 #include "config.h"
 
 #include <NeoPixelBus.h>
-#include <ArtnetWiFi.h>
+#include <soc/soc_caps.h>
 
 #include <map>
 #include <set>
 #include <list>
+#include <atomic>
 #include <Arduino.h>
 #include <TaskScheduler.h>
 #include <ArduinoLog.h>
@@ -27,6 +28,19 @@
 #include <GeneralUtils.h>
 #include <LittleFS.h>
 #include <DmxListener.h>
+#include <DmxFrameAssembler.h>
+#include <DmxMerger.h>
+#include <FramePacer.h>
+#include <DmxStateStore.h>
+#include <DmxAutosave.h>
+#include <DmxRecording.h>
+#include <ShowPlayer.h>
+#include <DmxScenes.h>
+#include <ArtNetReceiver.h>
+#include <ArtNetOutput.h>
+#include <E131Receiver.h>
+#include <DdpReceiver.h>
+#include <OscReceiver.h>
 #include <animations.h>
 #include <webadmin.h>
 #include <settings.h>
@@ -40,8 +54,23 @@
 #define ON_WIFI_EXECUTION_CALLBACK_SIGNATURE std::function<void(String)> wifiExecutionCallback
 
 // https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods
-std::map<int /* pin */, NeoPixelBus<NeoGrbwFeature, NeoEsp32RmtNSk6812Method>*> rgbwStrips;
-std::map<int /* pin */, NeoPixelBus<NeoGrbFeature, NeoEsp32RmtNWs2812xMethod>*> rgbStrips;
+// strips take the RMT channels first, then the lanes of the I2S parallel output (latched together)
+#define RMT_CHANNELS SOC_RMT_TX_CANDIDATES_PER_GROUP
+#if defined(CONFIG_IDF_TARGET_ESP32S2)
+#define I2S_PARALLEL_LANES 8
+typedef NeoEsp32I2s0X8Ws2812xMethod NeoI2sWs2812xMethod;
+typedef NeoEsp32I2s0X8Sk6812Method NeoI2sSk6812Method;
+#elif defined(CONFIG_IDF_TARGET_ESP32)
+#define I2S_PARALLEL_LANES 8
+typedef NeoEsp32I2s1X8Ws2812xMethod NeoI2sWs2812xMethod;
+typedef NeoEsp32I2s1X8Sk6812Method NeoI2sSk6812Method;
+#else
+#define I2S_PARALLEL_LANES 0 // no parallel output, the typedefs are never used
+typedef NeoEsp32Rmt0Ws2812xMethod NeoI2sWs2812xMethod;
+typedef NeoEsp32Rmt0Sk6812Method NeoI2sSk6812Method;
+#endif
+std::map<int /* pin */, PixelStrip<RgbwColor>*> rgbwStrips;
+std::map<int /* pin */, PixelStrip<RgbColor>*> rgbStrips;
 std::vector<LedThing*> leds;
 std::vector<ServoThing*> servos;
 std::vector<HumTempSensor*> humTempSensors;
@@ -49,6 +78,8 @@ std::vector<TouchSensor*> touchSensors;
 std::map<uint8_t /* pin */, DigitalReadSensor*> digitalReadSensors;
 std::map<uint8_t /* pin */, AnalogReadSensor*> analogReadSensors;
 std::vector<PWMFadeAnimationThing*> pwmFades;
+// pixel mapped strips in the config order (RGBW strips first), DDP output space
+std::vector<PixelMapBase*> pixelMaps;
 
 unsigned long lastCommandReceivedAt = 0;
 unsigned long maxIdleMillis = 0;
@@ -62,7 +93,13 @@ SettingsManager<Settings>* settingsManager;
 DmxListener* dmxListener;
 
 Scheduler scheduler;
-ArtnetWiFiReceiver* artnet;
+ArtNetReceiver* artnet;
+ArtNetOutput* artnetOutput;
+E131Receiver* e131;
+DdpReceiver* ddp;
+OscReceiver* osc;
+// OSC wrote to dmxData, not rendered yet
+bool oscPending = false;
 MqttUtils* mqtt;
 WebAdmin* webAdmin;
 
@@ -71,30 +108,278 @@ std::vector<Switchabe*> switchables;
 // uptime set by system reboot like WiFi connection failure
 ulong uptimeOffset = 0;
 
-uint16_t dmxUniverse;
-uint8_t lastDmxSequence = 0;
-uint8_t dmxData[512] = {0}; // 1st byte is sequence number
-
-int numOfCreatedStrips = 0;
-template<typename Feature, typename Method>
-void createStrip(int pin, int maxNeopx, std::map<int, NeoPixelBus<Feature, Method>*>& strips) {
-    Log.infoln("Initializing strip on pin %d ...", pin);
-    pinMode(pin, OUTPUT);
-
-    if (numOfCreatedStrips == 0) {
-        strips[pin] = new NeoPixelBus<Feature, Method>(maxNeopx, pin, NeoBusChannel_0);
-    } else if (numOfCreatedStrips == 1) {
-        strips[pin] = new NeoPixelBus<Feature, Method>(maxNeopx, pin, NeoBusChannel_1);
-    } else if (numOfCreatedStrips == 2) {
-        strips[pin] = new NeoPixelBus<Feature, Method>(maxNeopx, pin, NeoBusChannel_2);
-    } else {
-        Log.errorln("Reached maximum number of strips (3).");
-        return;
+// channel space of all the consecutive universes, universe data starts at (universe - 1st universe) * 512
+// owned by the render side (loop), received frames are taken from the frame buffer
+uint8_t* dmxData;
+uint16_t dmxDataLength = 0;
+DmxFrameAssembler* dmxFrameAssembler;
+DmxMerger* dmxMerger;
+FramePacer* framePacer;
+DmxStateStore* dmxStateStore;
+DmxAutosave* dmxAutosave;
+DmxRecorder* dmxRecorder;
+DmxPlayer* dmxPlayer;
+ShowPlayer* showPlayer;
+DmxScenes* dmxScenes;
+
+struct StripStats {
+    uint32_t shown;
+    uint32_t skipped;
+    unsigned long lastShownAt;
+};
+
+// by pin, entries are created with the strips
+std::map<int, StripStats> stripStats;
+unsigned long stripRefreshMillis = 0;
+
+StripOutput stripOutput = StripOutput::automatic;
+int numOfRmtStrips = 0;
+int numOfI2sStrips = 0;
+int numOfSpiStrips = 0;
+
+/**
+ * Clockless (one wire) chipsets, on the next free RMT channel or I2S lane.
+ */
+template<typename Feature, typename RmtMethod, typename I2sMethod>
+PixelStrip<typename Feature::ColorObject>* createClocklessStrip(const StripeCfg& cfg) {
+    pinMode(cfg.pin, OUTPUT);
+    bool rmt = stripOutput == StripOutput::rmt || (stripOutput == StripOutput::automatic && numOfRmtStrips < RMT_CHANNELS);
+    if (rmt && numOfRmtStrips < RMT_CHANNELS) {
+        int channel = numOfRmtStrips++;
+        return new NeoPixelStrip<Feature, RmtMethod>(String("RMT ") + channel, false, cfg.size, cfg.pin, (NeoBusChannel) channel);
+    } else if (!rmt && numOfI2sStrips < I2S_PARALLEL_LANES) {
+        int lane = numOfI2sStrips++;
+        return new NeoPixelStrip<Feature, I2sMethod>(String("I2S lane ") + lane, true, cfg.size, cfg.pin);
+    }
+    Log.errorln("No output left for the strip on pin %d (max. %d RMT, %d I2S).", cfg.pin, RMT_CHANNELS, I2S_PARALLEL_LANES);
+    return nullptr;
+}
+
+/**
+ * Clocked chipsets, on the hardware SPI (one strip).
+ */
+template<typename Feature, typename SpiMethod>
+PixelStrip<typename Feature::ColorObject>* createSpiStrip(const StripeCfg& cfg) {
+    if (cfg.clockPin < 0) {
+        Log.errorln("The strip on pin %d needs a clock_pin.", cfg.pin);
+        return nullptr;
+    }
+    if (numOfSpiStrips > 0) {
+        Log.errorln("No output left for the strip on pin %d (max. 1 SPI).", cfg.pin);
+        return nullptr;
+    }
+    numOfSpiStrips++;
+    return new SpiPixelStrip<Feature, SpiMethod>(String("SPI, clock pin ") + (int) cfg.clockPin, cfg.size, cfg.clockPin, cfg.pin);
+}
+
+/**
+ * Chipset and color order selected by the `type` of the strip config.
+ */
+template<typename T_COLOR>
+struct StripType {
+    const char* name;
+    PixelStrip<T_COLOR>* (*create)(const StripeCfg& cfg);
+};
+
+// the first type is the default
+const StripType<RgbColor> rgbStripTypes[] = {
+    {"ws2812", createClocklessStrip<NeoGrbFeature, NeoEsp32RmtNWs2812xMethod, NeoI2sWs2812xMethod>},
+    {"ws2812-rgb", createClocklessStrip<NeoRgbFeature, NeoEsp32RmtNWs2812xMethod, NeoI2sWs2812xMethod>},
+    {"ws2812-brg", createClocklessStrip<NeoBrgFeature, NeoEsp32RmtNWs2812xMethod, NeoI2sWs2812xMethod>},
+    {"apa102", createSpiStrip<DotStarBgrFeature, DotStarSpi20MhzMethod>},
+    {"apa102-10mhz", createSpiStrip<DotStarBgrFeature, DotStarSpi10MhzMethod>}, // long or noisy clock lines
+    {"sk9822", createSpiStrip<DotStarBgrFeature, DotStarSpi20MhzMethod>},
+};
+
+const StripType<RgbwColor> rgbwStripTypes[] = {
+    {"sk6812", createClocklessStrip<NeoGrbwFeature, NeoEsp32RmtNSk6812Method, NeoI2sSk6812Method>},
+    {"sk6812-rgbw", createClocklessStrip<NeoRgbwFeature, NeoEsp32RmtNSk6812Method, NeoI2sSk6812Method>},
+};
+
+/**
+ * Creates the strip of the configured type, nullptr if the type is unknown or there is no output left.
+ */
+template<typename T_COLOR, size_t N>
+PixelStrip<T_COLOR>* createStrip(const StripType<T_COLOR> (&types)[N], const StripeCfg& cfg) {
+    const StripType<T_COLOR>* type = cfg.type.empty() ? &types[0] : nullptr;
+    for (size_t i = 0; type == nullptr && i < N; i++) {
+        if (cfg.type == types[i].name) {
+            type = &types[i];
+        }
+    }
+    if (type == nullptr) {
+        Log.errorln("Unknown strip type %s on pin %d.", cfg.type.c_str(), cfg.pin);
+        return nullptr;
+    }
+    Log.infoln("Initializing %s strip on pin %d ...", type->name, cfg.pin);
+    auto strip = type->create(cfg);
+    if (strip == nullptr) {
+        return nullptr;
     }
-    numOfCreatedStrips++;
+    stripStats[cfg.pin] = StripStats{0, 0, 0};
     // this resets all the neopixels to an off state
-    strips[pin]->Begin();
-    strips[pin]->Show();
+    strip->Begin();
+    strip->Show();
+    Log.noticeln("Strip on pin %d: %s, %d px, %s.", cfg.pin, type->name, cfg.size, strip->getOutput().c_str());
+    return strip;
+}
+
+/**
+ * Sends the strip only if a pixel changed (or the refresh time elapsed).
+ */
+template<typename T_COLOR>
+void showStrip(int pin, PixelStrip<T_COLOR>* strip) {
+    auto& stats = stripStats[pin];
+    unsigned long now = millis();
+    if (!strip->IsDirty()) {
+        if (stripRefreshMillis == 0 || now - stats.lastShownAt < stripRefreshMillis) {
+            stats.skipped++;
+            return;
+        }
+        strip->Dirty(); // keep alive
+    }
+    strip->Show();
+    stats.shown++;
+    stats.lastShownAt = now;
+}
+
+/**
+ * Recording, playback, show and scene commands are executed by the render path, which reads the recorder, the players
+ * and the scenes. The web server runs in another task, it posts the commands and waits for the result.
+ */
+enum class DmxCommandType {
+    recordStart,
+    recordStop,
+    play,
+    playStop,
+    showStart,
+    showStop,
+    sceneSave,
+    sceneRecall,
+    stateSave,
+    stateReset
+};
+
+struct DmxCommand {
+    DmxCommandType type;
+    String name;
+    bool loop;
+    ShowPlayer::Clock clock;
+    uint32_t fade;
+    uint32_t id; // the result is sent to dmxCommandResultQueue, 0 means no result
+};
+
+struct DmxCommandResult {
+    uint32_t id;
+    bool ok;
+};
+
+#define DMX_COMMAND_TIMEOUT_MS 5000
+QueueHandle_t dmxCommandQueue;
+QueueHandle_t dmxCommandResultQueue;
+uint32_t lastDmxCommandId = 0;
+
+DmxCommand* newDmxCommand(DmxCommandType type, const String& name = "") {
+    auto command = new DmxCommand();
+    command->type = type;
+    command->name = name;
+    command->loop = true;
+    command->clock = ShowPlayer::INTERNAL;
+    command->fade = 0;
+    command->id = 0;
+    return command;
+}
+
+/**
+ * Queues the command for the render path, takes the ownership. Returns the result if `wait`, true otherwise.
+ */
+bool postDmxCommand(DmxCommand* command, bool wait = true) {
+    // web requests are handled one at a time, so a single result queue does
+    uint32_t id = wait ? ++lastDmxCommandId : 0;
+    command->id = id;
+    if (xQueueSend(dmxCommandQueue, &command, 0) != pdTRUE) {
+        Log.errorln("DMX command queue is full.");
+        delete command;
+        return false;
+    }
+    if (!wait) {
+        return true;
+    }
+    DmxCommandResult result;
+    while (xQueueReceive(dmxCommandResultQueue, &result, pdMS_TO_TICKS(DMX_COMMAND_TIMEOUT_MS)) == pdTRUE) {
+        if (result.id == id) {
+            return result.ok;
+        }
+        // a result of a command which timed out before
+    }
+    Log.errorln("DMX command timed out.");
+    return false;
+}
+
+/**
+ * Fades to the scene, the scene overrides the playback.
+ */
+bool recallScene(const String& name, uint32_t fadeMillis) {
+    if (!dmxScenes->recall(name, fadeMillis)) {
+        return false;
+    }
+    dmxPlayer->stop();
+    showPlayer->stop();
+    return true;
+}
+
+bool executeDmxCommand(DmxCommand& command) {
+    String path = String("/") + command.name;
+    switch (command.type) {
+        case DmxCommandType::recordStart: {
+            dmxPlayer->stop();
+            // keep some space for the file system itself
+            size_t freeBytes = LittleFS.totalBytes() - LittleFS.usedBytes();
+            size_t maxBytes = freeBytes > 16384 ? freeBytes - 16384 : 0;
+            return dmxRecorder->start(LittleFS, (path + ".dmx").c_str(), maxBytes);
+        }
+        case DmxCommandType::recordStop:
+            dmxRecorder->stop();
+            return true;
+        case DmxCommandType::play:
+            dmxRecorder->stop();
+            return dmxPlayer->start(LittleFS, (path + ".dmx").c_str(), command.loop);
+        case DmxCommandType::playStop:
+            dmxPlayer->stop();
+            return true;
+        case DmxCommandType::showStart:
+            return showPlayer->start(LittleFS, (path + ".show").c_str(), command.clock, command.loop);
+        case DmxCommandType::showStop:
+            showPlayer->stop();
+            return true;
+        case DmxCommandType::sceneSave:
+            return dmxScenes->save(command.name, dmxData);
+        case DmxCommandType::sceneRecall:
+            return recallScene(command.name, command.fade);
+        case DmxCommandType::stateSave:
+            return dmxStateStore->store(dmxData);
+        case DmxCommandType::stateReset: {
+            uint8_t* zeroData = new uint8_t[dmxDataLength]();
+            bool updated = dmxStateStore->store(zeroData);
+            delete[] zeroData;
+            return updated;
+        }
+    }
+    return false;
+}
+
+/**
+ * Executes the queued commands, called by the render path before rendering.
+ */
+void processDmxCommands() {
+    DmxCommand* command;
+    while (xQueueReceive(dmxCommandQueue, &command, 0) == pdTRUE) {
+        DmxCommandResult result = {command->id, executeDmxCommand(*command)};
+        if (result.id != 0) {
+            xQueueSend(dmxCommandResultQueue, &result, 0);
+        }
+        delete command;
+    }
 }
 
 WebAdmin::CommandResult onSystemCommand(JsonVariant &jsonVariant) {
@@ -164,12 +449,58 @@ WebAdmin::CommandResult onSystemCommand(JsonVariant &jsonVariant) {
     } else if (command == "reboot") {
         return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK_REBOOT, "Rebooting ...", 3000};
     } else if (command == "save-dmx") {
-        auto updated = dmxListener->storeDmxData(dmxData);
+        // stored by the render path, dmxData is written there and the autosave stores too
+        auto updated = postDmxCommand(newDmxCommand(DmxCommandType::stateSave));
         return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, updated ? "Saved." : "No updates.", -1};
     } else if (command == "reset-dmx") {
-        uint8_t zerroData[512] = {0};
-        auto updated = dmxListener->storeDmxData(zerroData);
+        auto updated = postDmxCommand(newDmxCommand(DmxCommandType::stateReset));
         return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, updated ? "Saved." : "No updates. All the values were 0 already. ", -1};
+    } else if (command == "record-start") {
+        if (!postDmxCommand(newDmxCommand(DmxCommandType::recordStart, jsonVariant["data"]["name"].as<String>()))) {
+            return WebAdmin::CommandResult{WebAdmin::CommandStatus::ERROR, "Recording could not be started.", -1};
+        }
+        return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, "Recording ...", -1};
+    } else if (command == "record-stop") {
+        postDmxCommand(newDmxCommand(DmxCommandType::recordStop));
+        return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, "Recording stopped.", -1};
+    } else if (command == "play") {
+        auto play = newDmxCommand(DmxCommandType::play, jsonVariant["data"]["name"].as<String>());
+        play->loop = jsonVariant["data"].containsKey("loop") ? jsonVariant["data"]["loop"].as<bool>() : true;
+        if (!postDmxCommand(play)) {
+            return WebAdmin::CommandResult{WebAdmin::CommandStatus::ERROR, "Recording could not be played.", -1};
+        }
+        return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, "Playing ...", -1};
+    } else if (command == "play-stop") {
+        postDmxCommand(newDmxCommand(DmxCommandType::playStop));
+        return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, "Playback stopped.", -1};
+    } else if (command == "show-start") {
+        auto show = newDmxCommand(DmxCommandType::showStart, jsonVariant["data"]["name"].as<String>());
+        show->clock = jsonVariant["data"]["clock"].as<String>() == "timecode" ? ShowPlayer::TIMECODE : ShowPlayer::INTERNAL;
+        show->loop = jsonVariant["data"].containsKey("loop") ? jsonVariant["data"]["loop"].as<bool>() : true;
+        if (!postDmxCommand(show)) {
+            return WebAdmin::CommandResult{WebAdmin::CommandStatus::ERROR, "Show could not be started.", -1};
+        }
+        return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, "Show started.", -1};
+    } else if (command == "show-stop") {
+        postDmxCommand(newDmxCommand(DmxCommandType::showStop));
+        return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, "Show stopped.", -1};
+    } else if (command == "scene-save") {
+        if (!postDmxCommand(newDmxCommand(DmxCommandType::sceneSave, jsonVariant["data"]["name"].as<String>()))) {
+            return WebAdmin::CommandResult{WebAdmin::CommandStatus::ERROR, "Scene could not be saved.", -1};
+        }
+        return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, "Scene saved.", -1};
+    } else if (command == "scene-recall") {
+        auto recall = newDmxCommand(DmxCommandType::sceneRecall, jsonVariant["data"]["name"].as<String>());
+        recall->fade = jsonVariant["data"]["fade"].as<uint32_t>();
+        if (!postDmxCommand(recall)) {
+            return WebAdmin::CommandResult{WebAdmin::CommandStatus::ERROR, "Scene not found.", -1};
+        }
+        return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, "Scene recalled.", -1};
+    } else if (command == "scene-delete") {
+        if (!dmxScenes->remove(jsonVariant["data"]["name"].as<String>())) {
+            return WebAdmin::CommandResult{WebAdmin::CommandStatus::ERROR, "Scene not found.", -1};
+        }
+        return WebAdmin::CommandResult{WebAdmin::CommandStatus::OK, "Scene deleted.", -1};
     }
     return WebAdmin::CommandResult{WebAdmin::CommandStatus::ERROR, "Unknown command.", -1};
 }
@@ -179,22 +510,44 @@ HeartbeatBroadcast* heartbeatBroadcast;
 xSemaphoreHandle semaphore = NULL;
 TaskHandle_t commitNeoStipTask;
 
+template<typename T_COLOR>
+void markParallelDirty(std::map<int, PixelStrip<T_COLOR>*>& strips) {
+    for (auto pair : strips) {
+        if (pair.second != nullptr && pair.second->isParallel()) {
+            pair.second->Dirty();
+        }
+    }
+}
+
 void doCommitThings() {
 
     for (auto led : leds) {
         led->commit();
     }
 
+    // a parallel output is sent once all its strips are shown
+    bool parallelDirty = false;
+    for (auto pair : rgbwStrips) {
+        parallelDirty |= pair.second != nullptr && pair.second->isParallel() && pair.second->IsDirty();
+    }
+    for (auto pair : rgbStrips) {
+        parallelDirty |= pair.second != nullptr && pair.second->isParallel() && pair.second->IsDirty();
+    }
+    if (parallelDirty) {
+        markParallelDirty(rgbwStrips);
+        markParallelDirty(rgbStrips);
+    }
+
     for (auto pair : rgbwStrips) {
         auto strip = pair.second;
         if (strip != nullptr) {
-            strip->Show();
+            showStrip(pair.first, strip);
         }
     }
     for (auto pair : rgbStrips) {
         auto strip = pair.second;
         if (strip != nullptr) {
-            strip->Show();
+            showStrip(pair.first, strip);
         }
     }
 
@@ -234,12 +587,17 @@ void initNeoStipTask() {
         0);                          /* pin task to core core_id */
 }
 
+ColorLut* createColorLut(const ColorCorrectionCfg& cfg) {
+    return new ColorLut(cfg.red, cfg.green, cfg.blue, cfg.white);
+}
+
 TailAnimation* tailAnimation1; // TODO make this configurable or pluggable
 TailAnimation* tailAnimation2;
 
-template<typename Feature, typename Method, class ThingType, class ThingGroupType>
+template<class ThingType, class ThingGroupType, typename T_COLOR, size_t N>
 std::vector<ThingGroupType*> createStripThings(
-        std::map<int, NeoPixelBus<Feature, Method> *>& strips,
+        const StripType<T_COLOR> (&types)[N],
+        std::map<int, PixelStrip<T_COLOR> *>& strips,
         std::vector<StripeCfg> stripeCfgs
     ) {
     std::vector<ThingType*> sliceThings;
@@ -252,8 +610,11 @@ std::vector<ThingGroupType*> createStripThings(
 
     std::vector<ThingGroupType*> groups;
     for (auto& stripeCfg : stripeCfgs) {
-        createStrip<Feature, Method>(stripeCfg.pin, stripeCfg.size, strips);
-        auto strip = strips[stripeCfg.pin];
+        auto strip = createStrip(types, stripeCfg);
+        strips[stripeCfg.pin] = strip;
+        if (strip == nullptr || stripeCfg.pixelMap) {
+            continue; // see createPixelMapThing
+        }
 
         // create led strip things for each slice, slices are defined by first pixel only, last pixel is calculated from the next slice
         // if slices are not defined, the whole strip is used as one thing (slice)
@@ -263,11 +624,13 @@ std::vector<ThingGroupType*> createStripThings(
             stripSlices.push_back(0);
         }
 
+        // the slices share the strip table, dimmers are applied per slice
+        auto lut = createColorLut(stripeCfg.colorCorrection);
         for (int i = 0; i < stripSlices.size(); i++) {
             int firstPx = stripSlices[i];
             int lastPx = i < stripSlices.size() - 1 ? stripSlices[i + 1] - 1 : strip->PixelCount() - 1;
             Log.noticeln("Creating led strip slice: %d-%d, dimmer mode %s.", firstPx, lastPx, dimmerModeToString(stripeCfg.dimmer).c_str());
-            auto thing = new ThingType(strip, firstPx, lastPx, stripeCfg.dimmer == DimmerMode::perSlice ? true : false);
+            auto thing = new ThingType(strip, firstPx, lastPx, stripeCfg.dimmer == DimmerMode::perSlice ? true : false, lut);
             sliceThings.push_back(thing);
         }
         ThingGroupType* group = new ThingGroupType(sliceThings, stripeCfg.dimmer == DimmerMode::single ? true : false);
@@ -276,6 +639,32 @@ std::vector<ThingGroupType*> createStripThings(
     return groups;
 };
 
+template<typename T_COLOR>
+SwitchableThing* createPixelMapThing(std::map<int, PixelStrip<T_COLOR> *>& strips, StripeCfg& stripeCfg) {
+    auto strip = strips[stripeCfg.pin];
+    Log.noticeln("Creating pixel mapped strip: %d pixels, dimmer mode %s.", strip->PixelCount(), dimmerModeToString(stripeCfg.dimmer).c_str());
+    auto thing = new PixelMapThing<T_COLOR>(strip, stripeCfg.dimmer != DimmerMode::none,
+        createColorLut(stripeCfg.colorCorrection), stripeCfg.universeChannels);
+    pixelMaps.push_back(thing);
+    return thing;
+}
+
+/**
+ * Index of the 1st channel of an explicitly patched thing in the channel space, -1 if the thing is mapped sequentially.
+ */
+int patchedChannel(const DmxPatchCfg& patch) {
+    if (!patch.isSet()) {
+        return -1;
+    }
+    uint16_t universe = patch.universe >= 0 ? patch.universe : dmxFrameAssembler->getFirstUniverse();
+    uint16_t address = patch.address > 0 ? patch.address : 1;
+    if (!dmxFrameAssembler->accepts(universe) || address > DmxFrameAssembler::UNIVERSE_SIZE) {
+        Log.errorln("DMX patch %d@%d is out of the listened universes, mapping sequentially.", address, universe);
+        return -1;
+    }
+    return (universe - dmxFrameAssembler->getFirstUniverse()) * DmxFrameAssembler::UNIVERSE_SIZE + address - 1;
+}
+
 std::vector<Switchabe*> createThings(Settings& settings) {
     std::vector<Switchabe*> switchables;
 
@@ -283,37 +672,54 @@ std::vector<Switchabe*> createThings(Settings& settings) {
     if (settings.leds.size() > 0) {
         analogWriteResolution(14);
         LedThing::set8bitTo14BitMapping();
-        for (auto& ledPin : settings.leds) {
+        for (auto& ledCfg : settings.leds) {
             // initialize led Things
-            auto ledThing = new LedThing(ledPin);
-            ledThing->setName(String("led-") + String(ledPin));
-            dmxListener->addThing(ledThing);
+            auto ledThing = new LedThing(ledCfg.pin);
+            ledThing->setName(String("led-") + String(ledCfg.pin));
+            dmxListener->addThing(ledThing, patchedChannel(ledCfg.patch));
             switchables.push_back(ledThing);
             leds.push_back(ledThing);
         }
         Log.noticeln("LEDs created.");
     }
 
+    stripOutput = settings.stripOutput;
     Log.noticeln("Creating RGBW strips ...");
-    std::vector<RgbwThingGroup*> rgbwThings = createStripThings<NeoGrbwFeature, NeoEsp32RmtNSk6812Method, RgbwThing, RgbwThingGroup>(rgbwStrips, settings.rgbwStrips);
-    for (auto& rgbwThing : rgbwThings) {
-        dmxListener->addThing(rgbwThing);
-        switchables.push_back(rgbwThing);
+    std::vector<RgbwThingGroup*> rgbwThings = createStripThings<RgbwThing, RgbwThingGroup>(rgbwStripTypes, rgbwStrips, settings.rgbwStrips);
+    auto rgbwGroup = rgbwThings.begin();
+    for (auto& stripeCfg : settings.rgbwStrips) {
+        if (rgbwStrips[stripeCfg.pin] == nullptr) {
+            continue;
+        }
+        SwitchableThing* thing = stripeCfg.pixelMap
+            ? createPixelMapThing(rgbwStrips, stripeCfg)
+            : *rgbwGroup++;
+        dmxListener->addThing(thing, patchedChannel(stripeCfg.patch));
+        switchables.push_back(thing);
     }
 
     Log.noticeln("Creating RGB strips ...");
-    std::vector<RgbThingGroup*> rgbThingsGroups = createStripThings<NeoGrbFeature, NeoEsp32RmtNWs2812xMethod, RgbThing, RgbThingGroup>(rgbStrips, settings.rgbStrips);
-    for (auto& rgbThing : rgbThingsGroups) {
-        dmxListener->addThing(rgbThing);
-        switchables.push_back(rgbThing);
+    std::vector<RgbThingGroup*> rgbThingsGroups = createStripThings<RgbThing, RgbThingGroup>(rgbStripTypes, rgbStrips, settings.rgbStrips);
+    auto rgbGroup = rgbThingsGroups.begin();
+    for (auto& stripeCfg : settings.rgbStrips) {
+        if (rgbStrips[stripeCfg.pin] == nullptr) {
+            continue;
+        }
+        SwitchableThing* thing = stripeCfg.pixelMap
+            ? createPixelMapThing(rgbStrips, stripeCfg)
+            : *rgbGroup++;
+        dmxListener->addThing(thing, patchedChannel(stripeCfg.patch));
+        switchables.push_back(thing);
     }
+    Log.noticeln("Strip outputs: %d of %d RMT channels, %d of %d I2S parallel lanes, %d of 1 SPI used.",
+        numOfRmtStrips, RMT_CHANNELS, numOfI2sStrips, I2S_PARALLEL_LANES, numOfSpiStrips);
 
     Log.noticeln("Creating servos ...");
     for (auto& servoCfg : settings.servos) {
         auto minPulseWidth = servoCfg.minPulseWidth == 0 ? 500 : servoCfg.minPulseWidth;
         auto maxPulseWidth = servoCfg.maxPulseWidth == 0 ? 2500 : servoCfg.maxPulseWidth;
         auto thing = new ServoThing(servoCfg.pin, servoCfg.maxAngle, minPulseWidth, maxPulseWidth);
-        dmxListener->addThing(thing);
+        dmxListener->addThing(thing, patchedChannel(servoCfg.patch));
         servos.push_back(thing);
     }
 
@@ -326,7 +732,7 @@ std::vector<Switchabe*> createThings(Settings& settings) {
             String(pwmFadeCfg.name.c_str()));
         pwmFades.push_back(pwmFade);
         dmxListener->removeThing(led);
-        dmxListener->addThing(pwmFade);
+        dmxListener->addThing(pwmFade, patchedChannel(pwmFadeCfg.patch));
     }
   // ANIMATIONS
   // auto rgbThing = rgbThings[0]; //TODO make this configurable
@@ -382,27 +788,206 @@ std::vector<Switchabe*> createThings(Settings& settings) {
         }
         auto wave = new Wave(&scheduler, waveLines, waveDef.maxFadeTime);
         Serial.println(String("Wave created with ") + waveLines.size() + " lines.");
-        dmxListener->addThing(wave);
+        dmxListener->addThing(wave, patchedChannel(waveDef.patch));
     }
     return switchables;
 };
 
-void onDmxFrame(const uint8_t *data, uint16_t size, const ArtDmxMetadata &metadata, const ArtNetRemoteInfo &remote) {
-    if (metadata.universe != dmxUniverse) {
+int renderCounter = 0;
+int renderTimeSum = 0;
+int maxRenderTime = 0;
+
+// frames are rendered by a dedicated task, woken by ArtSync and by published frames, the loop only renders without it
+TaskHandle_t dmxRenderTask = NULL;
+// things, dmxData and the pixel buffers are written by the render task and by the loop (scheduler, OSC, DDP)
+SemaphoreHandle_t renderMutex = NULL;
+
+void notifyDmxRender() {
+    if (dmxRenderTask != NULL) {
+        xTaskNotifyGive(dmxRenderTask);
+    }
+}
+
+// Art-Net sync mode, frames are committed when ArtSync arrives. Falls back to free-run if sync packets stop.
+#define ART_SYNC_TIMEOUT_MS 4000
+std::atomic<unsigned long> lastArtSyncAt{0};
+std::atomic<bool> artSyncPending{false};
+uint32_t artSyncs = 0;
+
+void onArtSync() {
+    if (lastArtSyncAt == 0 || millis() - lastArtSyncAt > ART_SYNC_TIMEOUT_MS) {
+        Log.noticeln("ArtSync received, entering sync mode.");
+    }
+    lastArtSyncAt = millis();
+    artSyncs++;
+    // a universe of the staged frame might be lost, don't wait for the timeout
+    if (dmxMerger != nullptr) {
+        dmxMerger->flush();
+    }
+    dmxFrameAssembler->flush();
+    artSyncPending.store(true, std::memory_order_release);
+    // latch right away, not after the loop got to it
+    notifyDmxRender();
+};
+
+bool isArtSyncMode() {
+    unsigned long syncAt = lastArtSyncAt;
+    return syncAt != 0 && millis() - syncAt <= ART_SYNC_TIMEOUT_MS;
+}
+
+// DMX is received in a dedicated task (the only writer of the frame assembler), frames are rendered by the loop
+TaskHandle_t dmxReceiveTask = NULL;
+// the sACN socket is reopened by the receive task once WiFi reconnects
+std::atomic<bool> e131BeginPending{false};
+
+void receiveDmx() {
+    if (artnet != nullptr && artnet->parse()) {
+        lastCommandReceivedAt = millis();
+    }
+    if (e131 != nullptr) {
+        if (e131BeginPending.exchange(false)) {
+            e131->begin();
+        }
+        if (e131->parse()) {
+            lastCommandReceivedAt = millis();
+        }
+    }
+    if (dmxMerger != nullptr) {
+        dmxMerger->poll();
+    }
+    dmxFrameAssembler->poll();
+}
+
+void dmxReceiveTaskProcedure(void *arg) {
+    while (true) {
+        receiveDmx();
+        if (dmxFrameAssembler->getFrameBuffer()->hasNewFrame()) {
+            notifyDmxRender();
+        }
+        // packets queue up in the socket meanwhile
+        vTaskDelay(1);
+    }
+}
+
+void initDmxReceiveTask(DmxReceiverCfg& cfg) {
+    if (cfg.core < 0) {
+        Log.noticeln("DMX is received in the main loop.");
         return;
     }
-    lastCommandReceivedAt = millis();
-    // ignore old sequencees unless counter flipped
-    if (metadata.sequence < lastDmxSequence && lastDmxSequence - metadata.sequence < 10) {
-        Log.traceln("Ignoring old sequence %d, last sequence: %d", metadata.sequence, lastDmxSequence);
+    // the ESP32-S2 has a single core
+    int core = cfg.core > portNUM_PROCESSORS - 1 ? portNUM_PROCESSORS - 1 : cfg.core;
+    if (xTaskCreatePinnedToCore(
+            dmxReceiveTaskProcedure,
+            "DmxReceiveTask",
+            4096,
+            NULL,
+            cfg.priority,
+            &dmxReceiveTask,
+            core) != pdPASS) {
+        Log.errorln("DMX receive task could not be created, receiving in the main loop.");
+        dmxReceiveTask = NULL;
         return;
     }
+    Log.noticeln("DMX receive task started on core %d, priority %d.", core, cfg.priority);
+}
 
-    for (int i = 0; i < 512; i++) {
-        dmxData[i] = data[i];
+/**
+ * Writes DDP data to the pixel mapped strips, the strips are concatenated in the DDP output space.
+ */
+void onDdpData(uint32_t offset, const uint8_t* data, uint16_t length) {
+    uint32_t stripOffset = 0;
+    for (auto pixelMap : pixelMaps) {
+        uint32_t stripLength = pixelMap->pixelDataLength();
+        if (offset < stripOffset + stripLength && offset + length > stripOffset) {
+            uint32_t skip = offset < stripOffset ? stripOffset - offset : 0;
+            pixelMap->setPixelData(offset + skip - stripOffset, data + skip, length - skip);
+        }
+        stripOffset += stripLength;
     }
-    // do not process the data here, leave IO callback as soon as possible
-};
+}
+
+/**
+ * Dispatches the newest received frame to the things and commits (latches) the outputs.
+ */
+void renderDmxFrame() {
+    // sensors write to dmxData as well, a new frame overrides them
+    uint32_t framePublishedAt = 0;
+    if (dmxFrameAssembler->getFrameBuffer()->takeLatest(dmxData, &framePublishedAt) && dmxRecorder->isRecording()) {
+        dmxRecorder->record(dmxData, framePublishedAt);
+    }
+    if (dmxPlayer->isPlaying()) {
+        // the playback overrides received frames
+        dmxPlayer->read(dmxData);
+        framePublishedAt = 0;
+    }
+    if (showPlayer->isPlaying()) {
+        showPlayer->read(dmxData);
+        framePublishedAt = 0;
+    }
+    if (dmxScenes->isFading()) {
+        // a fade overrides received frames until it ends, the scene stays until the next frame
+        dmxScenes->blend(dmxData);
+        framePublishedAt = 0;
+    }
+    oscPending = false;
+    unsigned long renderStartTime = micros();
+    if (dmxListener->processDmxData(dmxDataLength, dmxData)) {
+        dmxStateStore->markChanged();
+    }
+    if (PRINT_EXECUTION_STAT) {
+        auto renderTime = micros() - renderStartTime;
+        renderCounter++;
+        renderTimeSum += renderTime;
+        if (renderTime > maxRenderTime) {
+            maxRenderTime = renderTime;
+        }
+    }
+    commitNeoStip();
+    framePacer->rendered(framePublishedAt);
+}
+
+/**
+ * Executes the queued commands and renders if a latch is due, called with the render mutex taken.
+ */
+void renderIfDue() {
+    processDmxCommands();
+    if (artSyncPending.exchange(false, std::memory_order_acquire)) {
+        // latch the staged frame right away, all the synced nodes latch at the same time
+        renderDmxFrame();
+    } else if (!isArtSyncMode() && framePacer->shouldRender(dmxFrameAssembler->getFrameBuffer()->hasNewFrame()
+            || dmxPlayer->isFrameDue() || showPlayer->hasNewFrame() || dmxScenes->isFading() || oscPending)) {
+        renderDmxFrame();
+    }
+}
+
+void dmxRenderTaskProcedure(void *arg) {
+    while (true) {
+        // woken right away by ArtSync, new frames and the fixed pacing timer, polls the players and fades every tick
+        // otherwise
+        ulTaskNotifyTake(pdTRUE, 1);
+        xSemaphoreTake(renderMutex, portMAX_DELAY);
+        renderIfDue();
+        xSemaphoreGive(renderMutex);
+    }
+}
+
+void initDmxRenderTask() {
+    // above the loop on the loop core, so a wake up preempts the loop
+    if (xTaskCreatePinnedToCore(
+            dmxRenderTaskProcedure,
+            "DmxRenderTask",
+            8192,
+            NULL,
+            3,
+            &dmxRenderTask,
+            ARDUINO_RUNNING_CORE) != pdPASS) {
+        Log.errorln("DMX render task could not be created, rendering in the main loop.");
+        dmxRenderTask = NULL;
+        return;
+    }
+    framePacer->setRenderTask(dmxRenderTask);
+    Log.noticeln("DMX render task started on core %d.", ARDUINO_RUNNING_CORE);
+}
 
 void eraseAllPreferences() {
     esp_err_t err = nvs_flash_erase();
@@ -418,8 +1003,21 @@ void eraseAllPreferences() {
         }        
     }
 }
+String mqttSceneTopic = "";
+
 void onMqttMessage(char* topic, byte* payload, unsigned int length) {
     Log.noticeln("MQTT message received: %s, %s", topic, payload);
+    if (mqttSceneTopic == topic) {
+        // scene name, or {"name": "...", "fade": ms}
+        JsonDocument doc;
+        if (deserializeJson(doc, payload, length) == DeserializationError::Ok && doc.is<JsonObject>()) {
+            auto recall = newDmxCommand(DmxCommandType::sceneRecall, doc["name"].as<String>());
+            recall->fade = doc["fade"].as<uint32_t>();
+            postDmxCommand(recall, false);
+        } else {
+            postDmxCommand(newDmxCommand(DmxCommandType::sceneRecall, String((const char*) payload, length)), false);
+        }
+    }
 };
 
 void beforeWiFiReboot() {
@@ -511,8 +1109,19 @@ void setup() {
     Serial.println(String("Loaded settings: ") + settings.asJson().c_str());
     
     auto dmxSettings = dmxSettingsManager->getSettings();
-    dmxUniverse = dmxSettings.universe;
+    dmxFrameAssembler = new DmxFrameAssembler(dmxSettings.universe, dmxSettings.universes, settings.dmxReceiver.buffer);
+    dmxDataLength = dmxFrameAssembler->length();
+    dmxData = new uint8_t[dmxDataLength]();
+    dmxRecorder = new DmxRecorder(dmxDataLength);
+    dmxPlayer = new DmxPlayer(dmxDataLength);
+    showPlayer = new ShowPlayer(&scheduler, dmxDataLength);
+    dmxScenes = new DmxScenes(LittleFS, dmxDataLength);
+    Log.noticeln("Listening to %d universe(s) starting with universe %d.", dmxFrameAssembler->getNumUniverses(), dmxSettings.universe);
     dmxListener = new DmxListener(dmxSettings.channel);
+    auto pacing = dmxSettings.pacing == FramePacing::onFrame ? FramePacer::ON_FRAME
+        : dmxSettings.pacing == FramePacing::fixed ? FramePacer::FIXED : FramePacer::FREE;
+    framePacer = new FramePacer(pacing, dmxSettings.fps);
+    Log.noticeln("DMX frame pacing: %s, %d fps.", framePacingToString(dmxSettings.pacing).c_str(), framePacer->getFps());
 
     try {
         switchables = createThings(settings);
@@ -520,6 +1129,7 @@ void setup() {
     } catch(const std::exception& e) {
         Serial.println(String("ERR: creating things. ") + e.what());
     }
+    dmxListener->compile(dmxDataLength);
 
     // SENSORS ////
     Log.noticeln("Creating Hum/Temp sensor ...");
@@ -565,6 +1175,24 @@ void setup() {
 
     Log.noticeln("Mapping thing controls ...");
     for (auto& control : settings.thingControls) {
+        if (!control.scene.empty()) {
+            auto dReadSensor = getDigitalReadSensor(control.sensorPin);
+            if (dReadSensor == nullptr) {
+                Log.errorln("Scene %s control needs a digital read sensor.", control.scene.c_str());
+                continue;
+            }
+            String scene = control.scene.c_str();
+            uint16_t fade = control.fade;
+            dReadSensor->addOnChangeListener([scene, fade](bool value) {
+                if (value) {
+                    auto recall = newDmxCommand(DmxCommandType::sceneRecall, scene);
+                    recall->fade = fade;
+                    postDmxCommand(recall, false);
+                }
+            });
+            Log.noticeln("Scene %s mapped to sensor %d.", control.scene.c_str(), control.sensorPin);
+            continue;
+        }
         auto thingName = control.name.c_str();
         Log.traceln("Searching for thing %s ...", thingName);
         auto thing1stDmxCh = dmxListener->getThingChannelIndex(thingName);
@@ -575,6 +1203,10 @@ void setup() {
         Log.noticeln("Found 1st DMX channel %d for thing %s.", thing1stDmxCh, thingName);
 
         auto dmxChannel = thing1stDmxCh + control.dmxChOffset;
+        if (dmxChannel >= dmxDataLength) {
+            Log.errorln("DMX channel %d of thing %s is out of the channel space.", dmxChannel, thingName);
+            continue;
+        }
 
         auto dReadSensor = getDigitalReadSensor(control.sensorPin);
         if (dReadSensor != nullptr) {
@@ -593,6 +1225,45 @@ void setup() {
         }
     }
 
+    if (settings.artnetOutput.isEnabled()) {
+        Log.noticeln("Sending sensor values to Art-Net universe %d ...", settings.artnetOutput.universe);
+        artnetOutput = new ArtNetOutput(settings.artnetOutput.universe, settings.artnetOutput.ip.c_str(), settings.artnetOutput.maxRate);
+        artnetOutput->begin();
+        for (auto& channelCfg : settings.artnetOutput.channels) {
+            if (channelCfg.channel < 1 || channelCfg.channel > ArtNetOutput::UNIVERSE_SIZE) {
+                Log.errorln("Art-Net output channel %d of sensor %d is out of the universe.", channelCfg.channel, channelCfg.pin);
+                continue;
+            }
+            uint16_t channel = channelCfg.channel - 1;
+            bool found = false;
+            for (auto touchSensor : touchSensors) {
+                if (touchSensor->getPin() == channelCfg.pin) {
+                    touchSensor->addOnChangeListener([channel](bool touched) {
+                        artnetOutput->set(channel, touched ? 255 : 0);
+                    });
+                    found = true;
+                }
+            }
+            auto dReadSensor = getDigitalReadSensor(channelCfg.pin);
+            if (dReadSensor != nullptr) {
+                dReadSensor->addOnChangeListener([channel](bool value) {
+                    artnetOutput->set(channel, value ? 255 : 0);
+                });
+                found = true;
+            }
+            auto aReadSensor = getAnalogReadSensor(channelCfg.pin);
+            if (aReadSensor != nullptr) {
+                aReadSensor->addOnChangeListener([channel](uint16_t value) {
+                    artnetOutput->set(channel, value >> 5); // 13 bit to 8 bit
+                });
+                found = true;
+            }
+            if (!found) {
+                Log.errorln("Missing sensor %d for Art-Net output channel %d.", channelCfg.pin, channelCfg.channel);
+            }
+        }
+    }
+
     Serial.println("Mounting LittleFS ...");
     if (!LittleFS.begin()) {
         Serial.println("An Error has occurred while mounting LittleFS");
@@ -616,8 +1287,19 @@ void setup() {
 
     initNeoStipTask();
     firmwareUpdateResultQueue = xQueueCreate(1, sizeof(int));
+    renderMutex = xSemaphoreCreateMutex();
+    dmxCommandQueue = xQueueCreate(4, sizeof(DmxCommand*));
+    dmxCommandResultQueue = xQueueCreate(4, sizeof(DmxCommandResult));
+
+    dmxStateStore = new DmxStateStore(dmxDataLength);
+    dmxStateStore->load();
+    dmxStateStore->restore(dmxData);
+    if (settings.dmxAutosave.interval > 0) {
+        Log.noticeln("DMX autosave every %d s, max %d writes per hour.", settings.dmxAutosave.interval, settings.dmxAutosave.maxWritesPerHour);
+    }
+    dmxAutosave = new DmxAutosave(&scheduler, dmxStateStore, dmxData, settings.dmxAutosave.interval * 1000UL, settings.dmxAutosave.maxWritesPerHour);
 
-    dmxListener->restoreDmxData(dmxData);
+    stripRefreshMillis = settings.stripRefresh;
 
     if (settings.maxIdle > 0) {
         maxIdleMillis = settings.maxIdle * 60000;
@@ -635,14 +1317,49 @@ void setup() {
         settings.hostname.c_str());
     Serial.println("Wifi MAC: " + WifiUtils::macAddress);
 
-    if (!settings.disableArtnet) {
-        artnet = new ArtnetWiFiReceiver();
-        artnet->begin();
-        artnet->subscribeArtDmx(onDmxFrame);
-        artnet->setArtPollReplyConfigShortName("NetPins");
-        artnet->setArtPollReplyConfigLongName(String(WiFi.getHostname()) + " - " + dmxSettings.channel + "@" + dmxSettings.universe + " - " + FIRMWARE_VERSION);
-    } else {
+    if (settings.disableArtnet) {
         Log.noticeln("Artnet is disabled.");
+    } else if (dmxSettings.protocol == DmxProtocol::sacn) {
+        Log.noticeln("Receiving DMX over sACN (E1.31).");
+        e131 = new E131Receiver(dmxFrameAssembler); // multicast groups are joined once WiFi is connected
+    } else {
+        dmxMerger = new DmxMerger(dmxFrameAssembler, dmxSettings.merge == MergeMode::ltp ? DmxMerger::LTP : DmxMerger::HTP);
+        artnet = new ArtNetReceiver(dmxFrameAssembler, dmxMerger);
+        artnet->begin();
+        if (artnetOutput != nullptr) {
+            artnet->addInputUniverse(artnetOutput->getUniverse());
+        }
+        artnet->setOnSyncCallback(onArtSync);
+        artnet->setOnTimeCodeCallback([](uint32_t time) {
+            showPlayer->onTimeCode(time);
+        });
+        String universes = String(dmxSettings.universe);
+        if (dmxFrameAssembler->getNumUniverses() > 1) {
+            universes += String("-") + (dmxSettings.universe + dmxFrameAssembler->getNumUniverses() - 1);
+        }
+        artnet->setLongName(String(WiFi.getHostname()) + " - " + dmxSettings.channel + "@" + universes + " - " + FIRMWARE_VERSION);
+    }
+    if (artnet != nullptr || e131 != nullptr) {
+        initDmxReceiveTask(settings.dmxReceiver);
+    }
+
+    if (settings.enableDdp) {
+        if (pixelMaps.empty()) {
+            Log.warningln("DDP is enabled, but there are no pixel mapped strips.");
+        }
+        ddp = new DdpReceiver();
+        ddp->setOnDataCallback(onDdpData);
+        ddp->begin();
+        Log.noticeln("Receiving DDP on port %d.", DdpReceiver::PORT);
+    }
+
+    if (settings.oscPort > 0) {
+        osc = new OscReceiver(settings.oscPort);
+        osc->setChannelResolver([](const char* name) {
+            return dmxListener->getThingChannelIndex(name);
+        });
+        osc->begin();
+        Log.noticeln("Receiving OSC on port %d.", settings.oscPort);
     }
 
     if (_ENABLE_WEBSERVER) {
@@ -665,20 +1382,62 @@ void setup() {
             props[String("hum-") + humTempSensor->getPin()] = String(humTempSensor->getValue().temperature, 2);
         }
 
-        uint8_t dmxData[512];
-        dmxListener->restoreDmxData(dmxData);
+        const uint8_t* storedData = dmxStateStore->getShadow();
         // convert dmxData to string
         String dmxDataStr = ""; // TODO json sub-array
-        for (int i = 0; i < 512; i++) {
-            dmxDataStr += String(i+1) + ":" + String(dmxData[i]) + ",";
+        for (int i = 0; i < dmxDataLength; i++) {
+            dmxDataStr += String(i+1) + ":" + String(storedData[i]) + ",";
         }
         props["stored-dmx"] = dmxDataStr;
+        props["stored-dmx-writes"] = String(dmxStateStore->getWrites()) + ", journal entries: " + dmxStateStore->getJournalEntries()
+            + ", autosave skipped: " + dmxAutosave->getSkipped();
+        props["dropped-dmx-frames"] = String(dmxFrameAssembler->getFrameBuffer()->getDroppedFrames())
+            + ", buffer overflows: " + dmxFrameAssembler->getFrameBuffer()->getOverflowFrames();
+        props["dmx-recorder"] = dmxRecorder->isRecording() ? String("recording, records: ") + dmxRecorder->getRecords() : String("stopped");
+        props["dmx-player"] = dmxPlayer->isPlaying() ? "playing" : "stopped";
+        String scenes = "";
+        for (auto& scene : dmxScenes->list()) {
+            if (!scenes.isEmpty()) {
+                scenes += ", ";
+            }
+            scenes += scene;
+        }
+        props["dmx-scenes"] = scenes;
+        props["dmx-show"] = showPlayer->isPlaying() ? String("playing, time: ") + showPlayer->getShowTime() + " ms" : String("stopped");
+        props["dmx-latency"] = String("avg: ") + framePacer->getAvgLatency() + " us, max: " + framePacer->getMaxLatency() + " us";
+        if (dmxMerger != nullptr) {
+            for (auto& source : dmxMerger->getSourceStats()) {
+                props[String("dmx-source-") + IPAddress(source.ip).toString()] = String("packets: ") + source.packets
+                    + ", dropped: " + source.droppedPackets + ", lost: " + source.lostPackets + (source.active ? "" : ", inactive");
+            }
+            props["dmx-rejected-sources-packets"] = String(dmxMerger->getRejectedPackets());
+            props["art-sync"] = String(isArtSyncMode() ? "sync" : "free-run") + ", received: " + artSyncs;
+            props["artnet-packets"] = String("received: ") + artnet->getPackets() + ", rejected: " + artnet->getRejectedPackets();
+        }
+        for (auto& pair : stripStats) {
+            props[String("strip-") + pair.first] = String("shown: ") + pair.second.shown + ", skipped: " + pair.second.skipped;
+        }
+        if (artnetOutput != nullptr) {
+            props["artnet-output"] = String("universe: ") + artnetOutput->getUniverse() + ", sent: " + artnetOutput->getSentPackets();
+        }
+        if (osc != nullptr) {
+            props["osc-messages"] = String("received: ") + osc->getMessages() + ", rejected: " + osc->getRejectedMessages();
+        }
+        if (ddp != nullptr) {
+            props["ddp-packets"] = String("received: ") + ddp->getPackets() + ", rejected: " + ddp->getRejectedPackets()
+                + ", pushes: " + ddp->getPushes();
+        }
+        if (e131 != nullptr) {
+            props["sacn-packets"] = String("received: ") + e131->getPackets() + ", rejected: " + e131->getRejectedPackets()
+                + ", lost: " + e131->getLostPackets();
+        }
 
         return props;
     });
 
     String hostName = WifiUtils::getHostname(settings.hostname.c_str());
     mqttSensorTopicPreffix = String("netpins/") + hostName + "/sensor/";
+    mqttSceneTopic = String("netpins/") + hostName + "/command/scene";
     mqtt = new MqttUtils(
         settings.mqtt.server.c_str(),
         settings.mqtt.port,
@@ -689,6 +1448,7 @@ void setup() {
         onMqttMessage
     );
 
+    initDmxRenderTask();
     Log.noticeln("Running ...");
 }
 
@@ -698,6 +1458,14 @@ void onWifiExecutionCallback(String ip) {
         esp_wifi_set_ps(WIFI_PS_NONE); // Disable power-saving mode
     }
 
+    if (e131 != nullptr) {
+        if (dmxReceiveTask != NULL) {
+            e131BeginPending = true;
+        } else {
+            e131->begin();
+        }
+    }
+
     auto settigns = settingsManager->getSettings();
     if (_ENABLE_UDP_BROADCAST) {
         if (settigns.udpPort > 0) {
@@ -732,33 +1500,37 @@ int maxExecutionTime = 0;
 uint32_t minFreeHeap = UINT32_MAX;
 uint32_t minFreePsram = UINT32_MAX;
 
-unsigned long lastDmxCommit = 0;
 void loop() {
     unsigned long loopStartTime = micros();
 
+    xSemaphoreTake(renderMutex, portMAX_DELAY);
     scheduler.execute(); // scheduler should be before commitNeoStip because tasks usually prepare the data
+    xSemaphoreGive(renderMutex);
 
     FactoryReset::getInstance().resetCounter();
 
-    /*
-    30ms = 30fps
-    20ms = 50fps
-    13ms = 75fps
-    */
-    if (millis() - lastDmxCommit > 20) {
-        dmxListener->processDmxData(512, dmxData);
+    if (dmxReceiveTask == NULL) {
+        receiveDmx();
+    }
+    xSemaphoreTake(renderMutex, portMAX_DELAY);
+    if (osc != nullptr && osc->parse(dmxData, dmxDataLength)) {
+        oscPending = true;
+    }
+    if (dmxRenderTask == NULL) {
+        renderIfDue();
+    }
+    if (ddp != nullptr && ddp->parse()) {
+        // the pixel buffers are written already, latch them
         commitNeoStip();
-        lastDmxCommit = millis();
+        // the pixel maps changed behind the listener, the next DMX frame rewrites them even if its channels didn't change
+        dmxListener->invalidate();
     }
+    xSemaphoreGive(renderMutex);
 
     if (wifi != nullptr) {
         wifi->tryReconnect(onWifiExecutionCallback);
     }
     
-    if (artnet != nullptr) {
-        artnet->parse();
-    }
-
     for (auto& humTempSensor : humTempSensors) {
         humTempSensor->read();
     }
@@ -777,6 +1549,10 @@ void loop() {
         sensor->read();
     }
 
+    if (artnetOutput != nullptr) {
+        artnetOutput->update();
+    }
+
     mqtt->tryReconnect();
     mqtt->loop();
 
@@ -792,6 +1568,7 @@ void loop() {
         WiFi.mode(WIFI_OFF);
 
         // turn off all switchables
+        xSemaphoreTake(renderMutex, portMAX_DELAY);
         for (auto& switchable : switchables) {
             switchable->off();
         }
@@ -819,6 +1596,14 @@ void loop() {
 
         if (loopCounter % 5000 == 0) {
             Log.noticeln("Max loop execution time: %d us, avg loop execution time: %d us", maxExecutionTime, executionTimeSum / loopCounter);
+            Log.noticeln("Max DMX dispatch time: %d us, avg DMX dispatch time: %d us", maxRenderTime, renderCounter > 0 ? renderTimeSum / renderCounter : 0);
+            Log.noticeln("Dropped DMX frames: %d, buffer overflows: %d", dmxFrameAssembler->getFrameBuffer()->getDroppedFrames(),
+                dmxFrameAssembler->getFrameBuffer()->getOverflowFrames());
+            Log.noticeln("Max DMX packet-to-latch latency: %d us, avg: %d us", framePacer->getMaxLatency(), framePacer->getAvgLatency());
+            framePacer->resetLatency();
+            renderCounter = 0;
+            renderTimeSum = 0;
+            maxRenderTime = 0;
             executionTimeSum = 0;
             maxExecutionTime = 0;
             loopCounter = 0;
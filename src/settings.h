@@ -31,18 +31,253 @@ static std::string dimmerModeToString(DimmerMode dimmer) {
     }
 };
 
-struct StripeCfg {
+enum class DmxProtocol {
+    artnet,
+    sacn
+};
+
+static DmxProtocol dmxProtocolFromString(std::string protocol) {
+    if (protocol == "sacn") {
+        return DmxProtocol::sacn;
+    }
+    return DmxProtocol::artnet;
+};
+
+static std::string dmxProtocolToString(DmxProtocol protocol) {
+    switch (protocol) {
+        case DmxProtocol::sacn:
+            return "sacn";
+        default:
+            return "artnet";
+    }
+};
+
+enum class MergeMode {
+    htp,
+    ltp
+};
+
+static MergeMode mergeModeFromString(std::string merge) {
+    if (merge == "ltp") {
+        return MergeMode::ltp;
+    }
+    return MergeMode::htp;
+};
+
+static std::string mergeModeToString(MergeMode merge) {
+    switch (merge) {
+        case MergeMode::ltp:
+            return "ltp";
+        default:
+            return "htp";
+    }
+};
+
+enum class FramePacing {
+    free,
+    onFrame,
+    fixed
+};
+
+static FramePacing framePacingFromString(std::string pacing) {
+    if (pacing == "on-frame") {
+        return FramePacing::onFrame;
+    } else if (pacing == "fixed") {
+        return FramePacing::fixed;
+    }
+    return FramePacing::free;
+};
+
+static std::string framePacingToString(FramePacing pacing) {
+    switch (pacing) {
+        case FramePacing::onFrame:
+            return "on-frame";
+        case FramePacing::fixed:
+            return "fixed";
+        default:
+            return "free";
+    }
+};
+
+enum class StripOutput {
+    automatic, // RMT channels first, then the I2S parallel lanes
+    rmt,
+    i2s
+};
+
+static StripOutput stripOutputFromString(std::string output) {
+    if (output == "rmt") {
+        return StripOutput::rmt;
+    } else if (output == "i2s") {
+        return StripOutput::i2s;
+    }
+    return StripOutput::automatic;
+};
+
+static std::string stripOutputToString(StripOutput output) {
+    switch (output) {
+        case StripOutput::rmt:
+            return "rmt";
+        case StripOutput::i2s:
+            return "i2s";
+        default:
+            return "auto";
+    }
+};
+
+/**
+ * Optional explicit DMX patch of a thing. Things without a patch are mapped sequentially from the first DMX address.
+ * Read from / written to the `universe` and `address` keys of the thing object.
+ */
+struct DmxPatchCfg {
+    std::int32_t universe = -1; // -1 means the first listened universe
+    std::uint16_t address = 0; // 1-512, 0 means not patched
+
+    bool isSet() const {
+        return universe >= 0 || address > 0;
+    }
+
+    bool operator==(const DmxPatchCfg& other) const {
+        return universe == other.universe &&
+            address == other.address;
+    }
+
+    bool operator!=(const DmxPatchCfg& other) const {
+        return !(*this == other);
+    }
+
+    static DmxPatchCfg deserialize(JsonObject& json) {
+        DmxPatchCfg p;
+        if (json.containsKey("universe")) {
+            p.universe = json["universe"].as<std::int32_t>();
+        }
+        if (json.containsKey("address")) {
+            p.address = json["address"].as<std::uint16_t>();
+        }
+        return p;
+    }
+
+    static void serialize(JsonObject& json, const DmxPatchCfg& p) {
+        if (p.universe >= 0) {
+            json["universe"] = p.universe;
+        }
+        if (p.address > 0) {
+            json["address"] = p.address;
+        }
+    }
+};
+
+/**
+ * Per strip white balance, factors 0 - 255 per color, 255 means no correction.
+ */
+struct ColorCorrectionCfg {
+    std::uint8_t red = 255;
+    std::uint8_t green = 255;
+    std::uint8_t blue = 255;
+    std::uint8_t white = 255;
+
+    bool operator==(const ColorCorrectionCfg& other) const {
+        return red == other.red &&
+            green == other.green &&
+            blue == other.blue &&
+            white == other.white;
+    }
+
+    bool operator!=(const ColorCorrectionCfg& other) const {
+        return !(*this == other);
+    }
+
+    static ColorCorrectionCfg deserialize(JsonObject& json) {
+        ColorCorrectionCfg c;
+        if (json.containsKey("r")) {
+            c.red = json["r"].as<std::uint8_t>();
+        }
+        if (json.containsKey("g")) {
+            c.green = json["g"].as<std::uint8_t>();
+        }
+        if (json.containsKey("b")) {
+            c.blue = json["b"].as<std::uint8_t>();
+        }
+        if (json.containsKey("w")) {
+            c.white = json["w"].as<std::uint8_t>();
+        }
+        return c;
+    }
+
+    static void serialize(JsonObject& json, const ColorCorrectionCfg& c) {
+        json["r"] = c.red;
+        json["g"] = c.green;
+        json["b"] = c.blue;
+        json["w"] = c.white;
+    }
+};
+
+struct LedCfg {
     std::uint8_t pin;
+    DmxPatchCfg patch;
+
+    bool operator==(const LedCfg& other) const {
+        return pin == other.pin &&
+            patch == other.patch;
+    }
+
+    bool operator!=(const LedCfg& other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * Led is either a pin number or an object with the pin and the patch.
+     */
+    static LedCfg deserialize(JsonVariant& json) {
+        LedCfg l;
+        if (json.is<JsonObject>()) {
+            JsonObject jsonLed = json.as<JsonObject>();
+            l.pin = jsonLed["pin"].as<std::uint8_t>();
+            l.patch = DmxPatchCfg::deserialize(jsonLed);
+        } else {
+            l.pin = json.as<std::uint8_t>();
+        }
+        return l;
+    }
+
+    static void serialize(JsonArray& json, const LedCfg& l) {
+        if (!l.patch.isSet()) {
+            json.add(l.pin);
+            return;
+        }
+        JsonObject jsonLed = json.add<JsonObject>();
+        jsonLed["pin"] = l.pin;
+        DmxPatchCfg::serialize(jsonLed, l.patch);
+    }
+};
+
+struct StripeCfg {
+    // chipset and color order, empty means the default (ws2812 for RGB, sk6812 for RGBW strips)
+    std::string type;
+    std::uint8_t pin; // data pin
+    std::int8_t clockPin = -1; // clocked chipsets (apa102, sk9822) only
     std::uint16_t size;
     DimmerMode dimmer;
     // first pixel of each slice
     std::vector<std::uint16_t> slices;
+    // channels map to the pixels directly (3 or 4 channels per pixel), slices are ignored
+    bool pixelMap = false;
+    // pixel map only, channels used in each universe before the next one starts, 0 means whole pixels (510 RGB, 512 RGBW)
+    std::uint16_t universeChannels = 0;
+    ColorCorrectionCfg colorCorrection;
+    DmxPatchCfg patch;
 
     bool operator==(const StripeCfg& other) const {
-        return pin == other.pin &&
+        return type == other.type &&
+            pin == other.pin &&
+            clockPin == other.clockPin &&
             size == other.size &&
             dimmer == other.dimmer &&
-            slices == other.slices;
+            slices == other.slices &&
+            pixelMap == other.pixelMap &&
+            universeChannels == other.universeChannels &&
+            colorCorrection == other.colorCorrection &&
+            patch == other.patch;
     }
 
     bool operator!=(const StripeCfg& other) const {
@@ -51,7 +286,13 @@ struct StripeCfg {
 
     static StripeCfg deserialize(JsonObject& json) {
         StripeCfg s;
+        if (json.containsKey("type")) { // backward compatibility
+            s.type = json["type"].as<std::string>();
+        }
         s.pin = json["pin"].as<std::uint8_t>();
+        if (json.containsKey("clock_pin")) {
+            s.clockPin = json["clock_pin"].as<std::int8_t>();
+        }
         s.size = json["size"].as<std::uint16_t>();
         if (json.containsKey("dimmer")) { // backward compatibility
             s.dimmer = dimmerModeFromString(json["dimmer"].as<std::string>());
@@ -63,17 +304,43 @@ struct StripeCfg {
             auto slice = v.as<std::uint16_t>();
             s.slices.push_back(slice);
         }
+        if (json.containsKey("pixel_map")) { // backward compatibility
+            s.pixelMap = json["pixel_map"].as<bool>();
+        }
+        if (json.containsKey("universe_channels")) {
+            s.universeChannels = json["universe_channels"].as<std::uint16_t>();
+        }
+        if (json.containsKey("color_correction")) {
+            JsonObject jsonColorCorrection = json["color_correction"].as<JsonObject>();
+            s.colorCorrection = ColorCorrectionCfg::deserialize(jsonColorCorrection);
+        }
+        s.patch = DmxPatchCfg::deserialize(json);
         return s;
     }
 
     static void serialize(JsonObject& jsonStripe, const StripeCfg& s) {
+        if (!s.type.empty()) {
+            jsonStripe["type"] = s.type;
+        }
         jsonStripe["pin"] = s.pin;
+        if (s.clockPin >= 0) {
+            jsonStripe["clock_pin"] = s.clockPin;
+        }
         jsonStripe["size"] = s.size;
         jsonStripe["dimmer"] = dimmerModeToString(s.dimmer);
         JsonArray slices = jsonStripe["slices"].to<JsonArray>();
         for (auto slice : s.slices) {
             slices.add(slice);
         }
+        jsonStripe["pixel_map"] = s.pixelMap;
+        if (s.universeChannels != 0) {
+            jsonStripe["universe_channels"] = s.universeChannels;
+        }
+        if (s.colorCorrection != ColorCorrectionCfg()) {
+            JsonObject jsonColorCorrection = jsonStripe["color_correction"].to<JsonObject>();
+            ColorCorrectionCfg::serialize(jsonColorCorrection, s.colorCorrection);
+        }
+        DmxPatchCfg::serialize(jsonStripe, s.patch);
     }
 };
 
@@ -82,10 +349,12 @@ struct WaveCfg {
     std::uint32_t maxFadeTime = 10000;
     // index number of the rgb slices that are part of the wave. Fist slice defined in the config has index 0
     std::vector<uint8_t> sliceIndexes;
+    DmxPatchCfg patch;
 
     bool operator==(const WaveCfg& other) const {
         return maxFadeTime == other.maxFadeTime &&
-            sliceIndexes == other.sliceIndexes;
+            sliceIndexes == other.sliceIndexes &&
+            patch == other.patch;
     }
 
     bool operator!=(const WaveCfg& other) const {
@@ -100,6 +369,7 @@ struct WaveCfg {
             auto sliceIndex = v.as<std::uint8_t>();
             w.sliceIndexes.push_back(sliceIndex);
         }
+        w.patch = DmxPatchCfg::deserialize(json);
         return w;
     }
 
@@ -109,6 +379,7 @@ struct WaveCfg {
         for (auto sliceIndex : w.sliceIndexes) {
             sliceIndexes.add(sliceIndex);
         }
+        DmxPatchCfg::serialize(jsonWave, w.patch);
     }
 };
 
@@ -117,12 +388,14 @@ struct ServoCfg {
     std::uint8_t maxAngle;
     std::uint16_t minPulseWidth = 0;
     std::uint16_t maxPulseWidth = 0;
+    DmxPatchCfg patch;
 
     bool operator==(const ServoCfg& other) const {
         return pin == other.pin &&
             maxAngle == other.maxAngle &&
             minPulseWidth == other.minPulseWidth &&
-            maxPulseWidth == other.maxPulseWidth;
+            maxPulseWidth == other.maxPulseWidth &&
+            patch == other.patch;
     }
 
     bool operator!=(const ServoCfg& other) const {
@@ -139,6 +412,7 @@ struct ServoCfg {
         if (json.containsKey("max_pulse_width")) {
             s.maxPulseWidth = json["max_pulse_width"].as<std::uint16_t>();
         }
+        s.patch = DmxPatchCfg::deserialize(json);
         return s;
     }
 
@@ -151,6 +425,7 @@ struct ServoCfg {
         if (s.maxPulseWidth != 0) {
             jsonServo["max_pulse_width"] = s.maxPulseWidth;
         }
+        DmxPatchCfg::serialize(jsonServo, s.patch);
     }
 };
 
@@ -262,10 +537,12 @@ struct TouchSensorCfg {
 struct PwmFadeCfg {
     std::string name;
     std::uint8_t led;
+    DmxPatchCfg patch;
 
     bool operator==(const PwmFadeCfg& other) const {
         return name == other.name &&
-            led == other.led;
+            led == other.led &&
+            patch == other.patch;
     };
 
     bool operator!=(const PwmFadeCfg& other) const {
@@ -276,12 +553,14 @@ struct PwmFadeCfg {
         PwmFadeCfg p;
         p.name = json["name"].as<std::string>();
         p.led = json["led"].as<std::uint8_t>();
+        p.patch = DmxPatchCfg::deserialize(json);
         return p;
     };
 
     static void serialize(JsonObject& json, const PwmFadeCfg& p) {
         json["name"] = p.name;
         json["led"] = p.led;
+        DmxPatchCfg::serialize(json, p.patch);
     };
 };
 
@@ -293,11 +572,18 @@ struct ThingControlCfg {
      */
     std::uint8_t dmxChOffset;
     std::uint8_t sensorPin;
+    /**
+     * Scene recalled when the (digital) sensor gets on, the thing name is not used then.
+     */
+    std::string scene;
+    std::uint16_t fade = 0; // scene fade time in ms
 
     bool operator==(const ThingControlCfg& other) const {
         return name == other.name &&
             dmxChOffset == other.dmxChOffset &&
-            sensorPin == other.sensorPin;
+            sensorPin == other.sensorPin &&
+            scene == other.scene &&
+            fade == other.fade;
     };
 
     bool operator!=(const ThingControlCfg& other) const {
@@ -313,6 +599,10 @@ struct ThingControlCfg {
                 o.sensorPin = json["sensor"]["pin"].as<std::uint8_t>();        
             }
         }
+        if (json.containsKey("scene")) { // backward compatibility
+            o.scene = json["scene"].as<std::string>();
+            o.fade = json["fade"].as<std::uint16_t>();
+        }
         return o;
     }
 
@@ -325,6 +615,10 @@ struct ThingControlCfg {
         }
         JsonObject sensor = json["sensor"].to<JsonObject>();
         sensor["pin"] = o.sensorPin;
+        if (!o.scene.empty()) {
+            json["scene"] = o.scene;
+            json["fade"] = o.fade;
+        }
     };
 };
 
@@ -361,6 +655,148 @@ struct MqttCfg {
     };
 };
 
+struct DmxReceiverCfg {
+    std::int8_t core = 0; // core of the receive task, -1 receives in the main loop, core 0 exists on all the targets
+    std::uint8_t priority = 5;
+    std::uint8_t buffer = 3; // number of frames in the ring between the receive task and the render path
+
+    bool operator==(const DmxReceiverCfg& other) const {
+        return core == other.core &&
+            priority == other.priority &&
+            buffer == other.buffer;
+    };
+    bool operator!=(const DmxReceiverCfg& other) const {
+        return !(*this == other);
+    };
+
+    static DmxReceiverCfg deserialize(JsonObject& json) {
+        DmxReceiverCfg r;
+        if (json.containsKey("core")) {
+            r.core = json["core"].as<std::int8_t>();
+        }
+        if (json.containsKey("priority")) {
+            r.priority = json["priority"].as<std::uint8_t>();
+        }
+        if (json.containsKey("buffer")) {
+            r.buffer = json["buffer"].as<std::uint8_t>();
+        }
+        return r;
+    };
+
+    static void serialize(JsonObject& json, const DmxReceiverCfg& r) {
+        json["core"] = r.core;
+        json["priority"] = r.priority;
+        json["buffer"] = r.buffer;
+    };
+};
+
+struct DmxAutosaveCfg {
+    std::uint16_t interval = 0; // seconds, 0 means disabled
+    std::uint16_t maxWritesPerHour = 12; // flash write budget, 0 means unlimited
+
+    bool operator==(const DmxAutosaveCfg& other) const {
+        return interval == other.interval &&
+            maxWritesPerHour == other.maxWritesPerHour;
+    };
+    bool operator!=(const DmxAutosaveCfg& other) const {
+        return !(*this == other);
+    };
+
+    static DmxAutosaveCfg deserialize(JsonObject& json) {
+        DmxAutosaveCfg a;
+        if (json.containsKey("interval")) {
+            a.interval = json["interval"].as<std::uint16_t>();
+        }
+        if (json.containsKey("max_writes_per_hour")) {
+            a.maxWritesPerHour = json["max_writes_per_hour"].as<std::uint16_t>();
+        }
+        return a;
+    };
+
+    static void serialize(JsonObject& json, const DmxAutosaveCfg& a) {
+        json["interval"] = a.interval;
+        json["max_writes_per_hour"] = a.maxWritesPerHour;
+    };
+};
+
+struct SensorChannelCfg {
+    std::uint8_t pin; // pin of a touch, digital or analog read sensor
+    std::uint16_t channel; // 1 - 512
+
+    bool operator==(const SensorChannelCfg& other) const {
+        return pin == other.pin &&
+            channel == other.channel;
+    };
+    bool operator!=(const SensorChannelCfg& other) const {
+        return !(*this == other);
+    };
+
+    static SensorChannelCfg deserialize(JsonObject& json) {
+        SensorChannelCfg c;
+        c.pin = json["pin"].as<std::uint8_t>();
+        c.channel = json["channel"].as<std::uint16_t>();
+        return c;
+    };
+
+    static void serialize(JsonObject& json, const SensorChannelCfg& c) {
+        json["pin"] = c.pin;
+        json["channel"] = c.channel;
+    };
+};
+
+/**
+ * Sensor values sent as ArtDmx.
+ */
+struct ArtNetOutputCfg {
+    std::int16_t universe = -1; // -1 means disabled
+    std::string ip; // empty means the subnet broadcast
+    std::uint8_t maxRate = 30; // max packets per second
+    std::vector<SensorChannelCfg> channels;
+
+    bool isEnabled() const {
+        return universe >= 0;
+    }
+
+    bool operator==(const ArtNetOutputCfg& other) const {
+        return universe == other.universe &&
+            ip == other.ip &&
+            maxRate == other.maxRate &&
+            channels == other.channels;
+    };
+    bool operator!=(const ArtNetOutputCfg& other) const {
+        return !(*this == other);
+    };
+
+    static ArtNetOutputCfg deserialize(JsonObject& json) {
+        ArtNetOutputCfg o;
+        if (json.containsKey("universe")) {
+            o.universe = json["universe"].as<std::int16_t>();
+        }
+        if (json.containsKey("ip")) {
+            o.ip = json["ip"].as<std::string>();
+        }
+        if (json.containsKey("max_rate")) {
+            o.maxRate = json["max_rate"].as<std::uint8_t>();
+        }
+        JsonArray channelsArray = json["channels"].as<JsonArray>();
+        for (JsonObject v : channelsArray) {
+            o.channels.push_back(SensorChannelCfg::deserialize(v));
+        }
+        return o;
+    };
+
+    static void serialize(JsonObject& json, const ArtNetOutputCfg& o) {
+        json["universe"] = o.universe;
+        json["ip"] = o.ip;
+        json["max_rate"] = o.maxRate;
+        JsonArray channels = json["channels"].to<JsonArray>();
+        for (auto& channel : o.channels) {
+            JsonObject jsonChannel = channels.add<JsonObject>();
+            SensorChannelCfg::serialize(jsonChannel, channel);
+        }
+    };
+};
+
 struct Settings {
     std::string wifiSsid;
     std::string wifiPass;
@@ -368,7 +804,7 @@ struct Settings {
     std::uint32_t hbInt;
     std::uint16_t udpPort;
 
-    std::vector<std::uint8_t> leds;
+    std::vector<LedCfg> leds;
     std::vector<StripeCfg> rgbwStrips;
     std::vector<StripeCfg> rgbStrips;
     std::vector<ServoCfg> servos;
@@ -391,8 +827,15 @@ struct Settings {
     unsigned int rebootAfterWifiFailed = 15; // reboot after 15 failed wifi connections, 0 means no reboot
     bool disableWifiPowerSave;
     bool disableArtnet = false;
+    bool enableDdp = false; // DDP to the pixel mapped strips
+    std::uint16_t oscPort = 0; // OSC input, 0 means disabled
+    std::uint16_t stripRefresh = 0; // strips are re-sent after this time (ms) without a change, 0 means only on change
+    StripOutput stripOutput = StripOutput::automatic;
 
     MqttCfg mqtt;
+    DmxReceiverCfg dmxReceiver;
+    DmxAutosaveCfg dmxAutosave;
+    ArtNetOutputCfg artnetOutput;
 
     bool operator==(const Settings& other) const {
         return wifiSsid == other.wifiSsid &&
@@ -405,7 +848,14 @@ struct Settings {
             rebootAfterWifiFailed == other.rebootAfterWifiFailed &&
             disableWifiPowerSave == other.disableWifiPowerSave &&
             disableArtnet == other.disableArtnet &&
+            enableDdp == other.enableDdp &&
+            oscPort == other.oscPort &&
+            stripRefresh == other.stripRefresh &&
+            stripOutput == other.stripOutput &&
             mqtt == other.mqtt &&
+            dmxReceiver == other.dmxReceiver &&
+            dmxAutosave == other.dmxAutosave &&
+            artnetOutput == other.artnetOutput &&
 
             leds == other.leds &&
             rgbwStrips == other.rgbwStrips &&
@@ -446,18 +896,56 @@ struct Settings {
         } else {
             s.disableArtnet = false;
         }
+        if (json.containsKey("enable_ddp")) {
+            s.enableDdp = json["enable_ddp"].as<bool>();
+        } else {
+            s.enableDdp = false;
+        }
+        if (json.containsKey("osc_port")) {
+            s.oscPort = json["osc_port"].as<std::uint16_t>();
+        } else {
+            s.oscPort = 0;
+        }
+        if (json.containsKey("strip_refresh")) {
+            s.stripRefresh = json["strip_refresh"].as<std::uint16_t>();
+        } else {
+            s.stripRefresh = 0;
+        }
+        if (json.containsKey("strip_output")) {
+            s.stripOutput = stripOutputFromString(json["strip_output"].as<std::string>());
+        } else {
+            s.stripOutput = StripOutput::automatic;
+        }
         if (json.containsKey("mqtt")) {
             JsonObject jsonMqtt = json["mqtt"].as<JsonObject>();
             s.mqtt = MqttCfg::deserialize(jsonMqtt);
         } else {
             s.mqtt = MqttCfg();
         }
+        if (json.containsKey("dmx_receiver")) {
+            JsonObject jsonDmxReceiver = json["dmx_receiver"].as<JsonObject>();
+            s.dmxReceiver = DmxReceiverCfg::deserialize(jsonDmxReceiver);
+        } else {
+            s.dmxReceiver = DmxReceiverCfg();
+        }
+        if (json.containsKey("dmx_autosave")) {
+            JsonObject jsonDmxAutosave = json["dmx_autosave"].as<JsonObject>();
+            s.dmxAutosave = DmxAutosaveCfg::deserialize(jsonDmxAutosave);
+        } else {
+            s.dmxAutosave = DmxAutosaveCfg();
+        }
+        if (json.containsKey("artnet_output")) {
+            JsonObject jsonArtnetOutput = json["artnet_output"].as<JsonObject>();
+            s.artnetOutput = ArtNetOutputCfg::deserialize(jsonArtnetOutput);
+        } else {
+            s.artnetOutput = ArtNetOutputCfg();
+        }
 
         
         // actuators
         JsonArray ledsArray = json["leds"].as<JsonArray>();
         for (JsonVariant v : ledsArray) {
-            s.leds.push_back(v.as<std::uint8_t>());
+            s.leds.push_back(LedCfg::deserialize(v));
         }
 
         JsonArray rgbwStripsArray = json["rgbw_strips"].as<JsonArray>();
@@ -538,17 +1026,29 @@ struct Settings {
         json["reboot_after_wifi_failed"] = rebootAfterWifiFailed;
         json["disable_wifi_power_save"] = disableWifiPowerSave;
         json["disable_artnet"] = disableArtnet;
+        json["enable_ddp"] = enableDdp;
+        json["osc_port"] = oscPort;
+        json["strip_refresh"] = stripRefresh;
+        json["strip_output"] = stripOutputToString(stripOutput);
 
         if (mqtt.server != "") {
             JsonObject jsonMqtt = json["mqtt"].to<JsonObject>();
             MqttCfg::serialize(jsonMqtt, mqtt);
         }
+        JsonObject jsonDmxReceiver = json["dmx_receiver"].to<JsonObject>();
+        DmxReceiverCfg::serialize(jsonDmxReceiver, dmxReceiver);
+        JsonObject jsonDmxAutosave = json["dmx_autosave"].to<JsonObject>();
+        DmxAutosaveCfg::serialize(jsonDmxAutosave, dmxAutosave);
+        if (artnetOutput.isEnabled()) {
+            JsonObject jsonArtnetOutput = json["artnet_output"].to<JsonObject>();
+            ArtNetOutputCfg::serialize(jsonArtnetOutput, artnetOutput);
+        }
 
         // actuators
         if (leds.size() > 0) {
             JsonArray jsonLeds = json["leds"].to<JsonArray>();
             for (auto led : this->leds) {
-                jsonLeds.add(led);
+                LedCfg::serialize(jsonLeds, led);
             }
         }
 
@@ -660,10 +1160,24 @@ struct Settings {
 struct DmxSettings {
     std::uint16_t universe;
     std::uint16_t channel;
+    // number of consecutive universes starting with `universe`, assembled into one channel space
+    std::uint8_t universes = 1;
+    DmxProtocol protocol = DmxProtocol::artnet;
+    // merge mode of multiple Art-Net sources
+    MergeMode merge = MergeMode::htp;
+    // when the received frames are rendered
+    FramePacing pacing = FramePacing::free;
+    // max frame rate of on-frame pacing, frame rate of fixed pacing
+    std::uint8_t fps = 44;
 
     bool operator==(const DmxSettings& other) const {
         return universe == other.universe &&
-            channel == other.channel;
+            channel == other.channel &&
+            universes == other.universes &&
+            protocol == other.protocol &&
+            merge == other.merge &&
+            pacing == other.pacing &&
+            fps == other.fps;
     }
 
     bool operator!=(const DmxSettings& other) const {
@@ -673,11 +1187,44 @@ struct DmxSettings {
     static void deserialize(DmxSettings& s, JsonDocument& json) {
         s.universe = json["universe"].as<std::uint16_t>();
         s.channel = json["channel"].as<std::uint16_t>();
+        if (json.containsKey("universes")) { // backward compatibility
+            s.universes = json["universes"].as<std::uint8_t>();
+        } else {
+            s.universes = 1;
+        }
+        if (s.universes == 0) {
+            s.universes = 1;
+        }
+        if (json.containsKey("protocol")) {
+            s.protocol = dmxProtocolFromString(json["protocol"].as<std::string>());
+        } else {
+            s.protocol = DmxProtocol::artnet;
+        }
+        if (json.containsKey("merge")) {
+            s.merge = mergeModeFromString(json["merge"].as<std::string>());
+        } else {
+            s.merge = MergeMode::htp;
+        }
+        if (json.containsKey("pacing")) {
+            s.pacing = framePacingFromString(json["pacing"].as<std::string>());
+        } else {
+            s.pacing = FramePacing::free;
+        }
+        if (json.containsKey("fps") && json["fps"].as<std::uint8_t>() > 0) {
+            s.fps = json["fps"].as<std::uint8_t>();
+        } else {
+            s.fps = 44;
+        }
     };
 
     void serialize(JsonDocument& json) {
         json["universe"] = universe;
         json["channel"] = channel;
+        json["universes"] = universes;
+        json["protocol"] = dmxProtocolToString(protocol);
+        json["merge"] = mergeModeToString(merge);
+        json["pacing"] = framePacingToString(pacing);
+        json["fps"] = fps;
     };
 
     String asJson() {
@@ -691,6 +1238,11 @@ struct DmxSettings {
     void setDefaults() {
         this->universe = 0;
         this->channel = 1;
+        this->universes = 1;
+        this->protocol = DmxProtocol::artnet;
+        this->merge = MergeMode::htp;
+        this->pacing = FramePacing::free;
+        this->fps = 44;
     };
 };
 
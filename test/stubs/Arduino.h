@@ -0,0 +1,79 @@
+#pragma once
+
+// Host (native env) stand-in for the Arduino core, only what the tested headers use
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <string>
+
+typedef bool boolean;
+
+#define OUTPUT 0x03
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+}
+
+inline void analogWrite(uint8_t pin, int value) {
+}
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+class String : public std::string {
+    public:
+        String(const char* text = ""):
+                std::string(text) {
+        }
+
+        String(const std::string& text):
+                std::string(text) {
+        }
+
+        bool equals(const String& other) const {
+            return *this == other;
+        }
+};
+
+/**
+ * Time returned by micros() and millis(), set by the tests.
+ */
+inline uint32_t& fakeMicros() {
+    static uint32_t time = 0;
+    return time;
+}
+
+inline unsigned long micros() {
+    return fakeMicros();
+}
+
+inline unsigned long millis() {
+    return fakeMicros() / 1000;
+}
+
+class IPAddress {
+    private:
+        uint32_t address;
+
+    public:
+        IPAddress(uint32_t address = 0):
+                address(address) {
+        }
+
+        std::string toString() const {
+            char text[16];
+            snprintf(text, sizeof(text), "%u.%u.%u.%u", address & 0xFF, (address >> 8) & 0xFF, (address >> 16) & 0xFF, address >> 24);
+            return text;
+        }
+
+        operator uint32_t() const {
+            return address;
+        }
+
+        uint8_t operator[](int index) const {
+            return (address >> (index * 8)) & 0xFF;
+        }
+};
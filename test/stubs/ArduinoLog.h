@@ -0,0 +1,15 @@
+#pragma once
+
+// Host (native env) stand-in for ArduinoLog, the logs are dropped
+
+class Logging {
+    public:
+        template<typename... T_ARGS> void errorln(T_ARGS...) {}
+        template<typename... T_ARGS> void warningln(T_ARGS...) {}
+        template<typename... T_ARGS> void infoln(T_ARGS...) {}
+        template<typename... T_ARGS> void noticeln(T_ARGS...) {}
+        template<typename... T_ARGS> void traceln(T_ARGS...) {}
+        template<typename... T_ARGS> void verboseln(T_ARGS...) {}
+};
+
+static Logging Log;
@@ -0,0 +1,16 @@
+#pragma once
+
+// Host (native env) stand-in for the ESP32Servo library
+
+class Servo {
+    public:
+        void setPeriodHertz(int hertz) {
+        }
+
+        int attach(int pin, int min, int max) {
+            return 0;
+        }
+
+        void write(int value) {
+        }
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+// Host (native env) stand-in for the Arduino FS, the files are kept in memory
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+
+namespace fs {
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+class File {
+    private:
+        std::shared_ptr<std::vector<uint8_t>> data;
+        size_t offset = 0;
+
+    public:
+        File() {}
+
+        File(std::shared_ptr<std::vector<uint8_t>> data):
+                data(data) {
+        }
+
+        int read() {
+            if (!data || offset >= data->size()) {
+                return -1;
+            }
+            return (*data)[offset++];
+        }
+
+        size_t read(uint8_t* buffer, size_t size) {
+            if (!data) {
+                return 0;
+            }
+            if (size > data->size() - offset) {
+                size = data->size() - offset;
+            }
+            memcpy(buffer, data->data() + offset, size);
+            offset += size;
+            return size;
+        }
+
+        size_t write(const uint8_t* buffer, size_t size) {
+            if (!data) {
+                return 0;
+            }
+            data->insert(data->end(), buffer, buffer + size);
+            return size;
+        }
+
+        bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+            if (!data) {
+                return false;
+            }
+            size_t base = mode == SeekCur ? offset : mode == SeekEnd ? data->size() : 0;
+            if (base + pos > data->size()) {
+                return false;
+            }
+            offset = base + pos;
+            return true;
+        }
+
+        size_t position() {
+            return offset;
+        }
+
+        size_t size() {
+            return data ? data->size() : 0;
+        }
+
+        void close() {
+            data.reset();
+            offset = 0;
+        }
+
+        operator bool() const {
+            return (bool) data;
+        }
+};
+
+class FS {
+    private:
+        std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+
+    public:
+        File open(const char* path, const char* mode = FILE_READ) {
+            if (strcmp(mode, FILE_WRITE) == 0) {
+                files[path] = std::make_shared<std::vector<uint8_t>>();
+            }
+            auto file = files.find(path);
+            return file == files.end() ? File() : File(file->second);
+        }
+
+        bool exists(const char* path) {
+            return files.count(path) > 0;
+        }
+
+        bool remove(const char* path) {
+            return files.erase(path) > 0;
+        }
+};
+
+}
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
@@ -0,0 +1,96 @@
+#pragma once
+
+// Host (native env) pixel strip, the pixels are kept in memory in the G, R, B(, W) order of WS2812 and SK6812
+
+#include <vector>
+#include <PixelStrip.h>
+
+template<typename T_COLOR>
+class MemoryPixelStrip : public PixelStrip<T_COLOR> {
+    private:
+        static const uint8_t COLORS = T_COLOR::Count;
+
+        uint16_t count;
+        std::vector<uint8_t> pixels;
+        bool dirty = false;
+        String output = "memory";
+
+        static uint8_t colorAt(uint8_t position) {
+            // G, R, B, W
+            return position == 0 ? 1 : position == 1 ? 0 : position;
+        }
+
+    public:
+        using PixelStrip<T_COLOR>::ClearTo;
+
+        MemoryPixelStrip(uint16_t count):
+                count(count),
+                pixels(count * COLORS, 0) {
+        }
+
+        void Begin() {
+        }
+
+        void Show() {
+            dirty = false;
+        }
+
+        bool IsDirty() {
+            return dirty;
+        }
+
+        void Dirty() {
+            dirty = true;
+        }
+
+        uint16_t PixelCount() {
+            return count;
+        }
+
+        uint8_t* Pixels() {
+            return pixels.data();
+        }
+
+        size_t PixelsSize() {
+            return pixels.size();
+        }
+
+        size_t PixelSize() {
+            return COLORS;
+        }
+
+        void SetPixelColor(uint16_t index, T_COLOR color) {
+            encode(pixels.data() + index * COLORS, color);
+            dirty = true;
+        }
+
+        T_COLOR GetPixelColor(uint16_t index) {
+            T_COLOR color;
+            const uint8_t* pixel = pixels.data() + index * COLORS;
+            for (uint8_t i = 0; i < COLORS; i++) {
+                color[colorAt(i)] = pixel[i];
+            }
+            return color;
+        }
+
+        void ClearTo(T_COLOR color, uint16_t first, uint16_t last) {
+            for (uint16_t i = first; i <= last; i++) {
+                encode(pixels.data() + i * COLORS, color);
+            }
+            dirty = true;
+        }
+
+        void encode(uint8_t* pixel, T_COLOR color) {
+            for (uint8_t i = 0; i < COLORS; i++) {
+                pixel[i] = color[colorAt(i)];
+            }
+        }
+
+        bool isParallel() {
+            return false;
+        }
+
+        const String& getOutput() {
+            return output;
+        }
+};
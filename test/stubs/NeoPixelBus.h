@@ -0,0 +1,105 @@
+#pragma once
+
+// Host (native env) stand-in for NeoPixelBus, the colors and the gamma correction, the bus is not available
+
+#include <Arduino.h>
+
+struct RgbColor {
+    static const uint8_t Count = 3;
+
+    uint8_t R;
+    uint8_t G;
+    uint8_t B;
+
+    RgbColor(uint8_t r, uint8_t g, uint8_t b):
+            R(r), G(g), B(b) {
+    }
+
+    RgbColor(uint8_t brightness = 0):
+            R(brightness), G(brightness), B(brightness) {
+    }
+
+    uint8_t& operator[](size_t index) {
+        return index == 0 ? R : index == 1 ? G : B;
+    }
+
+    uint8_t operator[](size_t index) const {
+        return index == 0 ? R : index == 1 ? G : B;
+    }
+
+    bool operator==(const RgbColor& other) const {
+        return R == other.R && G == other.G && B == other.B;
+    }
+
+    bool operator!=(const RgbColor& other) const {
+        return !(*this == other);
+    }
+};
+
+struct RgbwColor {
+    static const uint8_t Count = 4;
+
+    uint8_t R;
+    uint8_t G;
+    uint8_t B;
+    uint8_t W;
+
+    RgbwColor(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0):
+            R(r), G(g), B(b), W(w) {
+    }
+
+    // like the library, the brightness goes to the white channel only
+    RgbwColor(uint8_t brightness = 0):
+            R(0), G(0), B(0), W(brightness) {
+    }
+
+    uint8_t& operator[](size_t index) {
+        return index == 0 ? R : index == 1 ? G : index == 2 ? B : W;
+    }
+
+    uint8_t operator[](size_t index) const {
+        return index == 0 ? R : index == 1 ? G : index == 2 ? B : W;
+    }
+
+    bool operator==(const RgbwColor& other) const {
+        return R == other.R && G == other.G && B == other.B && W == other.W;
+    }
+
+    bool operator!=(const RgbwColor& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Same curve as the table of the library (gamma 1 / 0.45).
+ */
+class NeoGammaTableMethod {
+    public:
+        static uint8_t Correct(uint8_t value) {
+            static uint8_t table[256];
+            static bool built = false;
+            if (!built) {
+                for (int i = 0; i < 256; i++) {
+                    table[i] = (uint8_t) (std::pow(i / 255.0, 1 / 0.45) * 255 + 0.5);
+                }
+                built = true;
+            }
+            return table[value];
+        }
+};
+
+template<typename T_METHOD>
+class NeoGamma {
+    public:
+        static RgbColor Correct(const RgbColor& original) {
+            return RgbColor(T_METHOD::Correct(original.R), T_METHOD::Correct(original.G), T_METHOD::Correct(original.B));
+        }
+
+        static RgbwColor Correct(const RgbwColor& original) {
+            return RgbwColor(T_METHOD::Correct(original.R), T_METHOD::Correct(original.G), T_METHOD::Correct(original.B),
+                T_METHOD::Correct(original.W));
+        }
+};
+
+template<typename T_COLOR_FEATURE, typename T_METHOD>
+class NeoPixelBus;
@@ -0,0 +1,19 @@
+#pragma once
+
+// Host (native env) stand-in for the WiFi of the Arduino core, the node is at 127.0.0.1
+
+#include <Arduino.h>
+
+class WiFiClass {
+    public:
+        IPAddress localIP() {
+            return IPAddress(0x0100007F);
+        }
+
+        uint8_t* macAddress(uint8_t* mac) {
+            memset(mac, 0, 6);
+            return mac;
+        }
+};
+
+static WiFiClass WiFi;
@@ -0,0 +1,10 @@
+#pragma once
+
+// Host (native env) stand-in for the lwIP sockets, the BSD sockets of the host
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
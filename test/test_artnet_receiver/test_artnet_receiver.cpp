@@ -0,0 +1,196 @@
+#include <unity.h>
+#include <chrono>
+#include <ArtNetReceiver.h>
+
+static const uint16_t UNIVERSE = 1;
+static const uint16_t BATCH = 64;
+static const uint32_t PACKETS = 64 * 200;
+
+static DmxFrameAssembler* assembler = nullptr;
+static DmxMerger* merger = nullptr;
+static ArtNetReceiver* receiver = nullptr;
+static int sender = -1;
+static struct sockaddr_in node = {};
+
+static void createPacket(uint8_t* packet, uint16_t universe, uint8_t sequence, uint8_t value) {
+    memcpy(packet, "Art-Net", 8);
+    packet[8] = ArtNetReceiver::OP_DMX & 0xFF;
+    packet[9] = ArtNetReceiver::OP_DMX >> 8;
+    packet[10] = 0;
+    packet[11] = 14; // protocol version
+    packet[12] = sequence;
+    packet[13] = 0;
+    packet[14] = universe & 0xFF;
+    packet[15] = universe >> 8;
+    packet[16] = 512 >> 8;
+    packet[17] = 512 & 0xFF;
+    memset(packet + ArtNetReceiver::HEADER_SIZE, value, 512);
+}
+
+static void send(uint16_t universe, uint8_t sequence, uint8_t value) {
+    uint8_t packet[ArtNetReceiver::HEADER_SIZE + 512];
+    createPacket(packet, universe, sequence, value);
+    sendto(sender, packet, sizeof(packet), 0, (struct sockaddr*) &node, sizeof(node));
+}
+
+/**
+ * Receive path of the ArtNet library used before, kept to compare with: WiFiUDP receives the datagram into its buffer,
+ * the library reads it into the packet buffer, checks the ID and the OpCode and passes the data to the callback,
+ * which compares the universe and copies the data.
+ */
+class LibraryPath {
+    private:
+        int sock;
+        uint8_t udpBuffer[1460];
+        uint8_t packet[530];
+        uint8_t dmxData[512];
+        uint8_t lastSequence = 0;
+
+    public:
+        uint32_t accepted = 0;
+
+        LibraryPath(int sock):
+                sock(sock) {
+        }
+
+        void parse() {
+            while (true) {
+                struct sockaddr_in from = {};
+                socklen_t fromLength = sizeof(from);
+                int size = recvfrom(sock, udpBuffer, sizeof(udpBuffer), 0, (struct sockaddr*) &from, &fromLength);
+                if (size <= 0) {
+                    return;
+                }
+                if (size > (int) sizeof(packet)) {
+                    size = sizeof(packet);
+                }
+                memcpy(packet, udpBuffer, size);
+                if (memcmp(packet, "Art-Net", 8) != 0) {
+                    continue;
+                }
+                uint16_t opCode = packet[8] | (packet[9] << 8);
+                if (opCode != ArtNetReceiver::OP_DMX) {
+                    continue;
+                }
+                uint8_t sequence = packet[12];
+                uint16_t universe = packet[14] | ((packet[15] & 0x7F) << 8);
+                uint16_t length = (packet[16] << 8) | packet[17];
+                if (universe != UNIVERSE) {
+                    continue;
+                }
+                if (sequence < lastSequence && lastSequence - sequence < 10) {
+                    continue;
+                }
+                lastSequence = sequence;
+                memcpy(dmxData, packet + ArtNetReceiver::HEADER_SIZE, length > 512 ? 512 : length);
+                accepted++;
+            }
+        }
+};
+
+/**
+ * Sends the packets in batches (the socket buffer holds a batch), `parse` receives each batch. Returns ns per packet
+ * spent in `parse`.
+ */
+template<typename T_PARSE>
+static double timeParse(uint16_t universe, T_PARSE parse) {
+    double nanos = 0;
+    for (uint32_t sent = 0; sent < PACKETS; sent += BATCH) {
+        for (uint16_t i = 0; i < BATCH; i++) {
+            send(universe, (sent + i) % 255 + 1, sent + i);
+        }
+        auto start = std::chrono::steady_clock::now();
+        parse();
+        nanos += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    return nanos / PACKETS;
+}
+
+void setUp() {
+    fakeMicros() = 0;
+    assembler = new DmxFrameAssembler(UNIVERSE, 1);
+    merger = new DmxMerger(assembler);
+    receiver = new ArtNetReceiver(assembler, merger);
+    TEST_ASSERT_TRUE(receiver->begin());
+    sender = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    node.sin_family = AF_INET;
+    node.sin_port = htons(ArtNetReceiver::PORT);
+    node.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+}
+
+void tearDown() {
+    close(sender);
+    delete receiver;
+    delete merger;
+    delete assembler;
+}
+
+void test_accepted_universe_is_received() {
+    send(UNIVERSE + 1, 1, 10);
+    send(UNIVERSE, 1, 20);
+    TEST_ASSERT_TRUE(receiver->parse());
+    TEST_ASSERT_EQUAL_UINT32(2, receiver->getPackets());
+    TEST_ASSERT_EQUAL_UINT32(1, receiver->getRejectedPackets());
+    uint8_t frame[512];
+    TEST_ASSERT_TRUE(assembler->getFrameBuffer()->takeLatest(frame));
+    TEST_ASSERT_EQUAL_UINT8(20, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(20, frame[511]);
+}
+
+void test_other_packets_are_rejected() {
+    uint8_t packet[ArtNetReceiver::HEADER_SIZE + 512];
+    createPacket(packet, UNIVERSE, 1, 1);
+    packet[0] = 'X';
+    sendto(sender, packet, sizeof(packet), 0, (struct sockaddr*) &node, sizeof(node));
+    // the header cut
+    createPacket(packet, UNIVERSE, 2, 1);
+    sendto(sender, packet, ArtNetReceiver::HEADER_SIZE - 1, 0, (struct sockaddr*) &node, sizeof(node));
+    TEST_ASSERT_FALSE(receiver->parse());
+    TEST_ASSERT_EQUAL_UINT32(2, receiver->getRejectedPackets());
+    TEST_ASSERT_FALSE(assembler->getFrameBuffer()->hasNewFrame());
+}
+
+/**
+ * Time spent receiving a packet over the loopback, both for a universe listened to and for another universe,
+ * the fast path against the library path.
+ */
+void test_parse_benchmark() {
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(ArtNetReceiver::PORT + 1);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_ASSERT_EQUAL(0, bind(sock, (struct sockaddr*) &addr, sizeof(addr)));
+    fcntl(sock, F_SETFL, O_NONBLOCK);
+    LibraryPath library(sock);
+    uint8_t frame[512];
+    char message[120];
+
+    for (uint16_t universe : {(uint16_t) (UNIVERSE + 1), UNIVERSE}) {
+        double nanos = timeParse(universe, [&]() {
+            receiver->parse();
+            assembler->getFrameBuffer()->takeLatest(frame);
+        });
+        node.sin_port = htons(ArtNetReceiver::PORT + 1);
+        double libraryNanos = timeParse(universe, [&]() {
+            library.parse();
+        });
+        node.sin_port = htons(ArtNetReceiver::PORT);
+        snprintf(message, sizeof(message), "%s universe: library path %.0f ns/packet, fast path %.0f ns/packet",
+            universe == UNIVERSE ? "accepted" : "other", libraryNanos, nanos);
+        TEST_MESSAGE(message);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2 * PACKETS, receiver->getPackets());
+    TEST_ASSERT_EQUAL_UINT32(PACKETS, receiver->getRejectedPackets());
+    TEST_ASSERT_EQUAL_UINT32(PACKETS, assembler->getCompleteFrames());
+    TEST_ASSERT_EQUAL_UINT32(PACKETS, library.accepted);
+    close(sock);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_accepted_universe_is_received);
+    RUN_TEST(test_other_packets_are_rejected);
+    RUN_TEST(test_parse_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,171 @@
+#include <unity.h>
+#include <chrono>
+#include <DmxFrameAssembler.h>
+
+static const uint16_t FIRST_UNIVERSE = 3;
+static const uint8_t UNIVERSES = 3;
+
+static void receive(DmxFrameAssembler& assembler, uint16_t universe, uint8_t value, uint16_t length = 512) {
+    uint8_t* data = assembler.beginUniverse(universe);
+    TEST_ASSERT_NOT_NULL(data);
+    memset(data, value, length);
+    assembler.endUniverse(universe, length);
+}
+
+static void assertUniverse(const uint8_t* frame, uint8_t index, uint8_t value) {
+    uint8_t expected[DmxFrameAssembler::UNIVERSE_SIZE];
+    memset(expected, value, sizeof(expected));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, frame + index * DmxFrameAssembler::UNIVERSE_SIZE, sizeof(expected));
+}
+
+void setUp() {
+    fakeMicros() = 0;
+}
+
+void tearDown() {
+}
+
+void test_universes_outside_are_rejected() {
+    DmxFrameAssembler assembler(FIRST_UNIVERSE, UNIVERSES);
+    TEST_ASSERT_FALSE(assembler.accepts(FIRST_UNIVERSE - 1));
+    TEST_ASSERT_TRUE(assembler.accepts(FIRST_UNIVERSE + UNIVERSES - 1));
+    TEST_ASSERT_FALSE(assembler.accepts(FIRST_UNIVERSE + UNIVERSES));
+    TEST_ASSERT_NULL(assembler.beginUniverse(FIRST_UNIVERSE + UNIVERSES));
+    TEST_ASSERT_EQUAL_UINT16(UNIVERSES * 512, assembler.length());
+}
+
+void test_complete_frame_is_published_in_universe_order() {
+    DmxFrameAssembler assembler(FIRST_UNIVERSE, UNIVERSES);
+    uint8_t frame[UNIVERSES * 512];
+    // universes arrive out of order
+    receive(assembler, FIRST_UNIVERSE + 2, 30);
+    receive(assembler, FIRST_UNIVERSE, 10);
+    TEST_ASSERT_FALSE(assembler.getFrameBuffer()->hasNewFrame());
+    receive(assembler, FIRST_UNIVERSE + 1, 20);
+    TEST_ASSERT_TRUE(assembler.getFrameBuffer()->takeLatest(frame));
+    assertUniverse(frame, 0, 10);
+    assertUniverse(frame, 1, 20);
+    assertUniverse(frame, 2, 30);
+    TEST_ASSERT_EQUAL_UINT32(1, assembler.getCompleteFrames());
+}
+
+void test_short_universe_is_zero_padded() {
+    DmxFrameAssembler assembler(FIRST_UNIVERSE, 1);
+    uint8_t frame[512];
+    receive(assembler, FIRST_UNIVERSE, 0xFF);
+    receive(assembler, FIRST_UNIVERSE, 7, 100);
+    TEST_ASSERT_TRUE(assembler.getFrameBuffer()->takeLatest(frame));
+    TEST_ASSERT_EQUAL_UINT8(7, frame[99]);
+    TEST_ASSERT_EQUAL_UINT8(0, frame[100]);
+    TEST_ASSERT_EQUAL_UINT8(0, frame[511]);
+}
+
+void test_lost_universe_keeps_last_values() {
+    DmxFrameAssembler assembler(FIRST_UNIVERSE, UNIVERSES);
+    uint8_t frame[UNIVERSES * 512];
+    receive(assembler, FIRST_UNIVERSE, 1);
+    receive(assembler, FIRST_UNIVERSE + 1, 2);
+    receive(assembler, FIRST_UNIVERSE + 2, 3);
+
+    // the 2nd universe is lost, the next frame starts
+    receive(assembler, FIRST_UNIVERSE, 4);
+    receive(assembler, FIRST_UNIVERSE + 2, 6);
+    receive(assembler, FIRST_UNIVERSE, 7);
+    TEST_ASSERT_TRUE(assembler.getFrameBuffer()->takeLatest(frame));
+    assertUniverse(frame, 0, 4);
+    assertUniverse(frame, 1, 2);
+    assertUniverse(frame, 2, 6);
+    TEST_ASSERT_EQUAL_UINT32(1, assembler.getIncompleteFrames());
+}
+
+void test_incomplete_frame_is_committed_on_timeout() {
+    DmxFrameAssembler assembler(FIRST_UNIVERSE, UNIVERSES, 3, 15);
+    receive(assembler, FIRST_UNIVERSE, 1);
+    fakeMicros() = 15000;
+    assembler.poll();
+    TEST_ASSERT_FALSE(assembler.getFrameBuffer()->hasNewFrame());
+    fakeMicros() = 16000;
+    assembler.poll();
+    TEST_ASSERT_TRUE(assembler.getFrameBuffer()->hasNewFrame());
+}
+
+void test_flush_commits_right_away() {
+    DmxFrameAssembler assembler(FIRST_UNIVERSE, UNIVERSES);
+    assembler.flush();
+    TEST_ASSERT_FALSE(assembler.getFrameBuffer()->hasNewFrame());
+    receive(assembler, FIRST_UNIVERSE + 1, 1);
+    assembler.flush();
+    TEST_ASSERT_TRUE(assembler.getFrameBuffer()->hasNewFrame());
+}
+
+void test_reader_takes_the_newest_frame() {
+    DmxFrameAssembler assembler(FIRST_UNIVERSE, 1, 4);
+    DmxFrameBuffer* buffer = assembler.getFrameBuffer();
+    uint8_t frame[512];
+    receive(assembler, FIRST_UNIVERSE, 1);
+    receive(assembler, FIRST_UNIVERSE, 2);
+    receive(assembler, FIRST_UNIVERSE, 3);
+    TEST_ASSERT_TRUE(buffer->takeLatest(frame));
+    assertUniverse(frame, 0, 3);
+    TEST_ASSERT_EQUAL_UINT32(2, buffer->getDroppedFrames());
+    TEST_ASSERT_FALSE(buffer->takeLatest(frame));
+}
+
+void test_writer_never_overwrites_published_frames() {
+    DmxFrameAssembler assembler(FIRST_UNIVERSE, 1, 3);
+    DmxFrameBuffer* buffer = assembler.getFrameBuffer();
+    uint8_t frame[512];
+    // the reader fell behind the whole ring
+    for (uint8_t i = 1; i <= 5; i++) {
+        receive(assembler, FIRST_UNIVERSE, i);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, buffer->getOverflowFrames());
+    TEST_ASSERT_TRUE(buffer->takeLatest(frame));
+    assertUniverse(frame, 0, 2);
+    receive(assembler, FIRST_UNIVERSE, 6);
+    TEST_ASSERT_TRUE(buffer->takeLatest(frame));
+    assertUniverse(frame, 0, 6);
+}
+
+/**
+ * Times the whole path of a frame of 8 universes: receiving the universes, publishing and taking the frame.
+ */
+void test_throughput() {
+    const uint8_t BENCH_UNIVERSES = 8;
+    const uint32_t FRAMES = 20000;
+    DmxFrameAssembler assembler(FIRST_UNIVERSE, BENCH_UNIVERSES);
+    static uint8_t frame[BENCH_UNIVERSES * 512];
+    uint32_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        for (uint8_t universe = 0; universe < BENCH_UNIVERSES; universe++) {
+            uint8_t* data = assembler.beginUniverse(FIRST_UNIVERSE + universe);
+            memset(data, i + universe, 512);
+            assembler.endUniverse(FIRST_UNIVERSE + universe, 512);
+        }
+        assembler.getFrameBuffer()->takeLatest(frame);
+        checksum += frame[i % sizeof(frame)];
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    char message[100];
+    snprintf(message, sizeof(message), "%u frames of %u channels: %.0f channels/s (checksum %u)", (unsigned int) FRAMES,
+        (unsigned int) assembler.length(), FRAMES * assembler.length() / seconds, (unsigned int) checksum);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, assembler.getCompleteFrames());
+    TEST_ASSERT_EQUAL_UINT32(0, assembler.getIncompleteFrames());
+    TEST_ASSERT_EQUAL_UINT32(0, assembler.getFrameBuffer()->getDroppedFrames());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_universes_outside_are_rejected);
+    RUN_TEST(test_complete_frame_is_published_in_universe_order);
+    RUN_TEST(test_short_universe_is_zero_padded);
+    RUN_TEST(test_lost_universe_keeps_last_values);
+    RUN_TEST(test_incomplete_frame_is_committed_on_timeout);
+    RUN_TEST(test_flush_commits_right_away);
+    RUN_TEST(test_reader_takes_the_newest_frame);
+    RUN_TEST(test_writer_never_overwrites_published_frames);
+    RUN_TEST(test_throughput);
+    return UNITY_END();
+}
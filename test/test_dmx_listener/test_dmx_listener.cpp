@@ -0,0 +1,161 @@
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include <DmxListener.h>
+#include <MemoryPixelStrip.h>
+
+// 1 pixel dimmable RGB things, 4 channels each, spanning 2 universes
+static const uint16_t THINGS = 240;
+static const uint16_t LENGTH = 1024;
+static const uint32_t FRAMES = 2000;
+
+static ColorLut lut;
+
+/**
+ * Per frame loop of the listener before the dispatch table, kept to compare with.
+ */
+static void legacyProcessDmxData(std::vector<Thing*>& thingList, int firstDmxChannel, uint16_t length, uint8_t* data) {
+    int currentDmxIndex = firstDmxChannel - 1;
+    for (auto& thing : thingList) {
+        if (currentDmxIndex + thing->numChannels() > length) {
+            break;
+        }
+        thing->setData(data + currentDmxIndex);
+        currentDmxIndex += thing->numChannels();
+    }
+}
+
+static int legacyThingChannelIndex(std::vector<Thing*>& thingList, String name) {
+    int channel = 0;
+    for (auto& thing : thingList) {
+        if (thing->getName().equals(name)) {
+            return channel;
+        }
+        channel += thing->numChannels();
+    }
+    return -1;
+}
+
+static RgbThing* createThing(PixelStrip<RgbColor>* strip, uint16_t index) {
+    RgbThing* thing = new RgbThing(strip, index, index, true, &lut);
+    thing->setName(String("thing-") + std::to_string(index));
+    return thing;
+}
+
+/**
+ * Frame `frame` of a show, `sparse` changes one channel per frame, otherwise all the channels change.
+ */
+static void nextFrame(uint8_t* data, uint32_t frame, bool sparse) {
+    if (sparse) {
+        data[frame % (THINGS * 4)]++;
+    } else {
+        for (uint16_t i = 0; i < LENGTH; i++) {
+            data[i] = i * 7 + frame;
+        }
+    }
+}
+
+static double nanosSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_patched_things_keep_the_sequential_block() {
+    MemoryPixelStrip<RgbColor> strip(3);
+    DmxListener listener(1);
+    listener.addThing(createThing(&strip, 0));
+    // patched to the 2nd universe
+    listener.addThing(createThing(&strip, 1), 512);
+    listener.addThing(createThing(&strip, 2));
+    uint8_t data[LENGTH] = {};
+    data[4] = 255;
+    data[7] = 255;
+    data[512] = 255;
+    data[515] = 255;
+    TEST_ASSERT_TRUE(listener.processDmxData(LENGTH, data));
+    TEST_ASSERT_EQUAL_UINT8(255, strip.GetPixelColor(1).R);
+    TEST_ASSERT_EQUAL_UINT8(255, strip.GetPixelColor(2).R);
+    TEST_ASSERT_EQUAL_INT(512, listener.getThingChannelIndex("thing-1"));
+    TEST_ASSERT_EQUAL_INT(4, listener.getThingChannelIndex("thing-2"));
+    TEST_ASSERT_EQUAL_INT(-1, listener.getThingChannelIndex("thing-3"));
+    // nothing changed
+    TEST_ASSERT_FALSE(listener.processDmxData(LENGTH, data));
+}
+
+/**
+ * 240 things: the dispatch table against the loop over the thing list, both with all the channels changing per frame
+ * and with one channel changing per frame, and the name index against the scan of the thing list.
+ */
+void test_dispatch_benchmark() {
+    MemoryPixelStrip<RgbColor> strip(THINGS);
+    MemoryPixelStrip<RgbColor> legacyStrip(THINGS);
+    DmxListener listener(1);
+    std::vector<Thing*> legacyThings;
+    for (uint16_t i = 0; i < THINGS; i++) {
+        listener.addThing(createThing(&strip, i));
+        legacyThings.push_back(createThing(&legacyStrip, i));
+    }
+    listener.compile(LENGTH);
+    uint8_t data[LENGTH] = {};
+    char message[120];
+
+    for (bool sparse : {false, true}) {
+        memset(data, 0, sizeof(data));
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < FRAMES; frame++) {
+            nextFrame(data, frame, sparse);
+            legacyProcessDmxData(legacyThings, 1, LENGTH, data);
+        }
+        double legacyNanos = nanosSince(start) / FRAMES;
+
+        memset(data, 0, sizeof(data));
+        start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < FRAMES; frame++) {
+            nextFrame(data, frame, sparse);
+            listener.processDmxData(LENGTH, data);
+        }
+        double nanos = nanosSince(start) / FRAMES;
+
+        snprintf(message, sizeof(message), "%d things, %s: thing list %.0f ns/frame, dispatch table %.0f ns/frame",
+            THINGS, sparse ? "1 channel changes" : "all channels change", legacyNanos, nanos);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(legacyStrip.Pixels(), strip.Pixels(), strip.PixelsSize());
+    }
+
+    const int ROUNDS = 20;
+    int checksum = 0;
+    int legacyChecksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (uint16_t i = 0; i < THINGS; i++) {
+            legacyChecksum += legacyThingChannelIndex(legacyThings, legacyThings[i]->getName());
+        }
+    }
+    double legacyNanos = nanosSince(start) / (ROUNDS * THINGS);
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (uint16_t i = 0; i < THINGS; i++) {
+            checksum += listener.getThingChannelIndex(legacyThings[i]->getName().c_str());
+        }
+    }
+    double nanos = nanosSince(start) / (ROUNDS * THINGS);
+    snprintf(message, sizeof(message), "%d things, name lookup: thing list %.0f ns, name index %.0f ns", THINGS, legacyNanos, nanos);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_INT(legacyChecksum, checksum);
+
+    for (auto thing : legacyThings) {
+        delete thing;
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_patched_things_keep_the_sequential_block);
+    RUN_TEST(test_dispatch_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,236 @@
+#include <unity.h>
+#include <DmxMerger.h>
+
+static const uint16_t UNIVERSE = 1;
+static const uint32_t MAIN = 0x0A00000A;
+static const uint32_t BACKUP = 0x0B00000A;
+
+static DmxFrameAssembler* assembler = nullptr;
+static DmxMerger* merger = nullptr;
+// last frame taken from the assembler
+static uint8_t frame[2 * 512];
+
+static void begin(DmxMerger::Mode mode, uint8_t universes = 1, unsigned long sourceTimeoutMillis = 10000) {
+    assembler = new DmxFrameAssembler(UNIVERSE, universes);
+    merger = new DmxMerger(assembler, mode, sourceTimeoutMillis);
+}
+
+/**
+ * Sends a universe with all the channels set to `value` except `channel` (if set), which is set to `channelValue`.
+ * Returns false if the packet was dropped.
+ */
+static bool send(uint32_t ip, uint8_t sequence, uint8_t value, int channel = -1, uint8_t channelValue = 0, uint16_t universe = UNIVERSE) {
+    uint8_t* data = merger->beginPacket(ip, universe, sequence);
+    if (data == nullptr) {
+        return false;
+    }
+    memset(data, value, 512);
+    if (channel >= 0) {
+        data[channel] = channelValue;
+    }
+    merger->endPacket(512);
+    return true;
+}
+
+static bool takeFrame() {
+    return assembler->getFrameBuffer()->takeLatest(frame);
+}
+
+void setUp() {
+    fakeMicros() = 0;
+}
+
+void tearDown() {
+    delete merger;
+    delete assembler;
+    merger = nullptr;
+    assembler = nullptr;
+}
+
+void test_htp_takes_the_highest_value() {
+    begin(DmxMerger::HTP);
+    send(MAIN, 1, 10, 5, 200);
+    TEST_ASSERT_TRUE(takeFrame());
+    send(BACKUP, 1, 20, 6, 0);
+    // merged with the next frame of the lead
+    TEST_ASSERT_FALSE(takeFrame());
+    send(MAIN, 2, 10, 5, 200);
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(20, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(200, frame[5]);
+    TEST_ASSERT_EQUAL_UINT8(10, frame[6]);
+}
+
+void test_ltp_takes_the_last_change() {
+    begin(DmxMerger::LTP);
+    send(MAIN, 1, 10);
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(10, frame[0]);
+    send(BACKUP, 1, 20);
+    // unchanged data of the main source doesn't take the universe back
+    send(MAIN, 2, 10);
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(20, frame[0]);
+    send(MAIN, 3, 5);
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(5, frame[0]);
+}
+
+void test_other_sources_commit_on_timeout_or_flush() {
+    begin(DmxMerger::HTP);
+    send(MAIN, 1, 10);
+    TEST_ASSERT_TRUE(takeFrame());
+    // a source sending on change only waits at most the frame timeout
+    send(BACKUP, 1, 30);
+    fakeMicros() = assembler->getTimeout() * 1000;
+    merger->poll();
+    TEST_ASSERT_FALSE(takeFrame());
+    fakeMicros() += 1000;
+    merger->poll();
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(30, frame[0]);
+
+    send(BACKUP, 2, 40);
+    merger->flush();
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(40, frame[0]);
+    merger->flush();
+    TEST_ASSERT_FALSE(takeFrame());
+}
+
+void test_backup_takes_over_after_timeout() {
+    begin(DmxMerger::LTP, 1, 1000);
+    send(MAIN, 1, 10);
+    send(BACKUP, 1, 10);
+    fakeMicros() = 500000;
+    send(MAIN, 2, 50);
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(50, frame[0]);
+    // the main source stopped, the backup becomes the lead and holds its values
+    fakeMicros() = 1600000;
+    send(BACKUP, 2, 10);
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(10, frame[0]);
+    auto stats = merger->getSourceStats();
+    TEST_ASSERT_EQUAL(2, stats.size());
+    TEST_ASSERT_FALSE(stats[0].active);
+    TEST_ASSERT_TRUE(stats[1].active);
+}
+
+/**
+ * Two sources interleave their packets of two universes, each tick is published once with both universes merged.
+ */
+void test_interleaved_sources_publish_one_frame_per_tick() {
+    begin(DmxMerger::HTP, 2);
+    const int TICKS = 20;
+    for (int tick = 1; tick <= TICKS; tick++) {
+        // the main source raises channel 0, the backup channel 1 of both the universes
+        send(MAIN, tick, 0, 0, tick, UNIVERSE);
+        TEST_ASSERT_FALSE(assembler->getFrameBuffer()->hasNewFrame());
+        send(BACKUP, tick, 0, 1, tick, UNIVERSE);
+        send(BACKUP, tick, 0, 1, tick, UNIVERSE + 1);
+        TEST_ASSERT_FALSE(assembler->getFrameBuffer()->hasNewFrame());
+        send(MAIN, tick, 0, 0, tick, UNIVERSE + 1);
+        TEST_ASSERT_TRUE(takeFrame());
+        for (int universe = 0; universe < 2; universe++) {
+            TEST_ASSERT_EQUAL_UINT8(tick, frame[universe * 512]);
+            TEST_ASSERT_EQUAL_UINT8(tick, frame[universe * 512 + 1]);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(TICKS, assembler->getCompleteFrames());
+    TEST_ASSERT_EQUAL_UINT32(0, assembler->getIncompleteFrames());
+    TEST_ASSERT_EQUAL_UINT32(0, assembler->getFrameBuffer()->getDroppedFrames());
+}
+
+/**
+ * Packets of the other source arriving after the lead completed the tick are merged into the next tick.
+ */
+void test_late_packets_go_to_the_next_tick() {
+    begin(DmxMerger::HTP, 2);
+    for (int tick = 1; tick <= 10; tick++) {
+        send(MAIN, tick, 0, 0, tick, UNIVERSE);
+        send(BACKUP, tick, 0, 1, tick, UNIVERSE);
+        send(MAIN, tick, 0, 0, tick, UNIVERSE + 1);
+        TEST_ASSERT_TRUE(takeFrame());
+        send(BACKUP, tick, 0, 1, tick, UNIVERSE + 1);
+        TEST_ASSERT_FALSE(assembler->getFrameBuffer()->hasNewFrame());
+        TEST_ASSERT_EQUAL_UINT8(tick, frame[1]);
+        TEST_ASSERT_EQUAL_UINT8(tick - 1, frame[512 + 1]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, assembler->getCompleteFrames());
+}
+
+void test_lost_universe_of_the_lead_commits_once() {
+    begin(DmxMerger::HTP, 2);
+    send(MAIN, 1, 1, -1, 0, UNIVERSE);
+    // the 2nd universe is lost, the next tick starts
+    send(MAIN, 2, 2, -1, 0, UNIVERSE);
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(1, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, frame[512]);
+    send(MAIN, 3, 3, -1, 0, UNIVERSE + 1);
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(2, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(3, frame[512]);
+    TEST_ASSERT_EQUAL_UINT32(2, assembler->getCompleteFrames());
+}
+
+void test_old_sequences_are_dropped() {
+    begin(DmxMerger::HTP);
+    TEST_ASSERT_TRUE(send(MAIN, 250, 1));
+    TEST_ASSERT_FALSE(send(MAIN, 249, 2));
+    // 4 packets lost
+    TEST_ASSERT_TRUE(send(MAIN, 255, 3));
+    // the counter flipped, 0 is skipped
+    TEST_ASSERT_TRUE(send(MAIN, 1, 4));
+    // sequence 0 is not tracked
+    TEST_ASSERT_TRUE(send(MAIN, 0, 5));
+    auto stats = merger->getSourceStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats[0].droppedPackets);
+    TEST_ASSERT_EQUAL_UINT32(4, stats[0].lostPackets);
+}
+
+void test_sources_over_the_limit_are_rejected() {
+    begin(DmxMerger::HTP);
+    for (uint32_t i = 0; i < DmxMerger::MAX_SOURCES; i++) {
+        TEST_ASSERT_TRUE(send(MAIN + i, 1, 1));
+    }
+    TEST_ASSERT_FALSE(send(BACKUP, 1, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, merger->getRejectedPackets());
+    TEST_ASSERT_NULL(merger->beginPacket(MAIN, UNIVERSE + 1, 1));
+}
+
+/**
+ * A packet which could not be received (no `endPacket`) doesn't activate the source nor count in the sequence tracking.
+ */
+void test_packets_not_received_are_ignored() {
+    begin(DmxMerger::HTP);
+    TEST_ASSERT_NOT_NULL(merger->beginPacket(MAIN, UNIVERSE, 10));
+    TEST_ASSERT_EQUAL(0, merger->getSourceStats()[0].packets);
+    TEST_ASSERT_FALSE(merger->getSourceStats()[0].active);
+    TEST_ASSERT_TRUE(send(MAIN, 11, 1));
+    TEST_ASSERT_NOT_NULL(merger->beginPacket(MAIN, UNIVERSE, 12));
+    TEST_ASSERT_TRUE(send(MAIN, 13, 2));
+    auto stats = merger->getSourceStats();
+    TEST_ASSERT_TRUE(stats[0].active);
+    TEST_ASSERT_EQUAL_UINT32(2, stats[0].packets);
+    // the packet 12 was lost
+    TEST_ASSERT_EQUAL_UINT32(1, stats[0].lostPackets);
+    TEST_ASSERT_TRUE(takeFrame());
+    TEST_ASSERT_EQUAL_UINT8(2, frame[0]);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_htp_takes_the_highest_value);
+    RUN_TEST(test_ltp_takes_the_last_change);
+    RUN_TEST(test_other_sources_commit_on_timeout_or_flush);
+    RUN_TEST(test_backup_takes_over_after_timeout);
+    RUN_TEST(test_interleaved_sources_publish_one_frame_per_tick);
+    RUN_TEST(test_late_packets_go_to_the_next_tick);
+    RUN_TEST(test_lost_universe_of_the_lead_commits_once);
+    RUN_TEST(test_old_sequences_are_dropped);
+    RUN_TEST(test_sources_over_the_limit_are_rejected);
+    RUN_TEST(test_packets_not_received_are_ignored);
+    return UNITY_END();
+}
@@ -0,0 +1,306 @@
+#include <unity.h>
+#include <vector>
+#include <DmxRecording.h>
+
+// 2 universes, runs cross the universe boundary
+static const uint16_t LENGTH = 1024;
+static const uint32_t MAX_BYTES = 1024 * 1024;
+
+struct Frame {
+    uint32_t time; // micros
+    std::vector<uint8_t> data;
+};
+
+static fs::FS files;
+static uint32_t seed;
+
+static uint8_t nextRandom() {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 16;
+}
+
+/**
+ * Frames with full, sparse, adjacent and no changes, received at a cadence not aligned to ms.
+ */
+static std::vector<Frame> createFrames() {
+    std::vector<Frame> frames;
+    std::vector<uint8_t> data(LENGTH, 0);
+    uint32_t time = 1000000;
+    seed = 1;
+    for (int i = 0; i < 40; i++) {
+        switch (i % 5) {
+            case 0:
+                for (auto& value : data) {
+                    value = nextRandom();
+                }
+                break;
+            case 1:
+                data[nextRandom() * 4] ^= 0xFF;
+                break;
+            case 2:
+                // a run gap shorter and longer than `RUN_GAP`
+                data[10]++;
+                data[12]++;
+                data[20]++;
+                data[511]++;
+                data[512]++;
+                break;
+            case 3:
+                data[LENGTH - 1]++;
+                break;
+            default:
+                // no change, not recorded
+                break;
+        }
+        frames.push_back({time, data});
+        time += 22727;
+    }
+    return frames;
+}
+
+static void record(const std::vector<Frame>& frames, uint32_t endTime) {
+    DmxRecorder recorder(LENGTH);
+    TEST_ASSERT_TRUE(recorder.start(files, "/rec.npdr", MAX_BYTES));
+    for (auto& frame : frames) {
+        fakeMicros() = frame.time;
+        recorder.record(frame.data.data(), frame.time);
+    }
+    fakeMicros() = endTime;
+    recorder.stop();
+    TEST_ASSERT_FALSE(recorder.isRecording());
+}
+
+/**
+ * Plays the frames back, each one must be due exactly at its recorded time (ms) since the start and not before.
+ * The first `length` channels are compared.
+ */
+static void assertPlayed(DmxPlayer& player, const std::vector<Frame>& frames, uint32_t startedAt, uint16_t length = LENGTH) {
+    uint8_t data[LENGTH];
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (i > 0 && frames[i].data == frames[i - 1].data) {
+            continue;
+        }
+        uint32_t dueAt = startedAt + (frames[i].time - frames[0].time) / 1000 * 1000;
+        if (i > 0) {
+            fakeMicros() = dueAt - 1000;
+            TEST_ASSERT_FALSE(player.isFrameDue());
+        }
+        fakeMicros() = dueAt;
+        TEST_ASSERT_TRUE(player.isFrameDue());
+        TEST_ASSERT_TRUE(player.read(data));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(frames[i].data.data(), data, length);
+    }
+}
+
+/**
+ * A show at 44 Hz: a slow color fade of 10 RGB fixtures, a 4 Hz dimmer chase and a cue (100 channels) every 30 s.
+ */
+class ShowCapture {
+    public:
+        static const uint32_t FPS = 44;
+
+    private:
+        uint32_t index = 0;
+
+    public:
+        uint8_t data[LENGTH] = {};
+
+        uint32_t time() {
+            return 1000000 + (uint64_t) index * 1000000 / FPS;
+        }
+
+        void next() {
+            index++;
+            // triangle wave with a 20 s period
+            uint32_t phase = index % (20 * FPS);
+            uint32_t level = phase < 10 * FPS ? phase * 255 / (10 * FPS) : (20 * FPS - phase) * 255 / (10 * FPS);
+            for (uint16_t i = 0; i < 30; i++) {
+                data[i] = i % 3 == 0 ? level : i % 3 == 1 ? 255 - level : level / 2;
+            }
+            for (uint16_t i = 0; i < 16; i++) {
+                data[512 + i] = i == index / 11 % 16 ? 255 : 0;
+            }
+            if (index % (30 * FPS) == 0) {
+                seed = index;
+                for (uint16_t i = 100; i < 200; i++) {
+                    data[i] = nextRandom();
+                }
+            }
+        }
+};
+
+void setUp() {
+    files = fs::FS();
+    fakeMicros() = 0;
+}
+
+void tearDown() {
+}
+
+void test_round_trip() {
+    auto frames = createFrames();
+    uint32_t endTime = frames.back().time + 100000;
+    record(frames, endTime);
+
+    DmxPlayer player(LENGTH);
+    fakeMicros() = 50000000;
+    TEST_ASSERT_TRUE(player.start(files, "/rec.npdr", false));
+    assertPlayed(player, frames, 50000000);
+
+    // stops at the recorded end
+    uint8_t data[LENGTH];
+    fakeMicros() = 50000000 + (endTime - frames[0].time) / 1000 * 1000;
+    TEST_ASSERT_FALSE(player.read(data));
+    TEST_ASSERT_FALSE(player.isPlaying());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frames.back().data.data(), data, LENGTH);
+}
+
+void test_loop_keeps_period() {
+    auto frames = createFrames();
+    uint32_t endTime = frames.back().time + 100000;
+    record(frames, endTime);
+
+    DmxPlayer player(LENGTH);
+    fakeMicros() = 50000000;
+    TEST_ASSERT_TRUE(player.start(files, "/rec.npdr", true));
+    assertPlayed(player, frames, 50000000);
+    // the 2nd loop starts exactly one recording length later
+    uint32_t period = (endTime - frames[0].time) / 1000 * 1000;
+    assertPlayed(player, frames, 50000000 + period);
+    TEST_ASSERT_TRUE(player.isPlaying());
+}
+
+void test_unchanged_frames_are_not_recorded() {
+    auto frames = createFrames();
+    record(frames, frames.back().time);
+
+    DmxRecorder recorder(LENGTH);
+    TEST_ASSERT_TRUE(recorder.start(files, "/rec2.npdr", MAX_BYTES));
+    for (auto& frame : frames) {
+        recorder.record(frame.data.data(), frame.time);
+    }
+    // every 5th frame repeats the previous one
+    TEST_ASSERT_EQUAL_UINT32(frames.size() / 5 * 4, recorder.getRecords());
+    recorder.stop();
+}
+
+void test_size_limit_stops_recording() {
+    auto frames = createFrames();
+    DmxRecorder recorder(LENGTH);
+    TEST_ASSERT_TRUE(recorder.start(files, "/rec.npdr", 3 * LENGTH));
+    for (auto& frame : frames) {
+        recorder.record(frame.data.data(), frame.time);
+    }
+    TEST_ASSERT_FALSE(recorder.isRecording());
+
+    // what was recorded plays back
+    DmxPlayer player(LENGTH);
+    TEST_ASSERT_TRUE(player.start(files, "/rec.npdr", false));
+}
+
+void test_invalid_file_is_rejected() {
+    File file = files.open("/bad.npdr", FILE_WRITE);
+    const uint8_t header[] = {'N', 'P', 'D', 'X', DmxRecording::VERSION, 0, 4};
+    file.write(header, sizeof(header));
+    file.close();
+
+    DmxPlayer player(LENGTH);
+    TEST_ASSERT_FALSE(player.start(files, "/bad.npdr", false));
+    TEST_ASSERT_FALSE(player.start(files, "/missing.npdr", false));
+    TEST_ASSERT_FALSE(player.isPlaying());
+}
+
+void test_truncated_recording_stops() {
+    auto frames = createFrames();
+    record(frames, frames.back().time);
+    std::vector<uint8_t> content;
+    File file = files.open("/rec.npdr");
+    for (int b = file.read(); b >= 0; b = file.read()) {
+        content.push_back(b);
+    }
+    file.close();
+    // cut in the middle of the 1st record, a full frame
+    file = files.open("/cut.npdr", FILE_WRITE);
+    file.write(content.data(), DmxRecording::HEADER_SIZE + LENGTH / 2);
+    file.close();
+
+    DmxPlayer player(LENGTH);
+    uint8_t data[LENGTH];
+    TEST_ASSERT_TRUE(player.start(files, "/cut.npdr", true));
+    TEST_ASSERT_FALSE(player.read(data));
+    TEST_ASSERT_FALSE(player.isPlaying());
+}
+
+void test_recording_with_more_channels_is_clamped() {
+    auto frames = createFrames();
+    uint32_t endTime = frames.back().time + 100000;
+    record(frames, endTime);
+
+    // the runs crossing channel 512 are cut, the runs behind it are skipped
+    DmxPlayer player(LENGTH / 2);
+    fakeMicros() = 50000000;
+    TEST_ASSERT_TRUE(player.start(files, "/rec.npdr", false));
+    assertPlayed(player, frames, 50000000, LENGTH / 2);
+    TEST_ASSERT_TRUE(player.isPlaying());
+}
+
+void test_ten_minutes_capture() {
+    const uint32_t FRAMES = 10 * 60 * ShowCapture::FPS;
+    DmxRecorder recorder(LENGTH);
+    TEST_ASSERT_TRUE(recorder.start(files, "/show.npdr", 4 * 1024 * 1024));
+    ShowCapture capture;
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        capture.next();
+        fakeMicros() = capture.time();
+        recorder.record(capture.data, capture.time());
+    }
+    uint32_t endTime = capture.time() + 1000000 / ShowCapture::FPS;
+    fakeMicros() = endTime;
+    recorder.stop();
+    File file = files.open("/show.npdr");
+    size_t bytesPerMinute = file.size() / 10;
+    file.close();
+    char message[80];
+    snprintf(message, sizeof(message), "%u frames, %u records, %u bytes per minute", (unsigned int) FRAMES,
+        (unsigned int) recorder.getRecords(), (unsigned int) bytesPerMinute);
+    TEST_MESSAGE(message);
+    // 10 minutes stay under 640 kB, within the file system partition of a 4 MB board
+    TEST_ASSERT_LESS_THAN(64 * 1024, bytesPerMinute);
+
+    DmxPlayer player(LENGTH);
+    uint32_t startedAt = 50000000;
+    fakeMicros() = startedAt;
+    TEST_ASSERT_TRUE(player.start(files, "/show.npdr", false));
+    ShowCapture replay;
+    replay.next();
+    uint32_t firstTime = replay.time();
+    uint8_t last[LENGTH] = {};
+    uint8_t data[LENGTH];
+    for (uint32_t i = 0; i < FRAMES; i++, replay.next()) {
+        if (i > 0 && memcmp(last, replay.data, LENGTH) == 0) {
+            continue;
+        }
+        memcpy(last, replay.data, LENGTH);
+        uint32_t dueAt = startedAt + (replay.time() - firstTime) / 1000 * 1000;
+        fakeMicros() = dueAt - 1000;
+        TEST_ASSERT_TRUE(i == 0 || !player.isFrameDue());
+        fakeMicros() = dueAt;
+        TEST_ASSERT_TRUE(player.read(data));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(replay.data, data, LENGTH);
+    }
+    fakeMicros() = startedAt + (endTime - firstTime) / 1000 * 1000;
+    TEST_ASSERT_FALSE(player.read(data));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_loop_keeps_period);
+    RUN_TEST(test_unchanged_frames_are_not_recorded);
+    RUN_TEST(test_size_limit_stops_recording);
+    RUN_TEST(test_invalid_file_is_rejected);
+    RUN_TEST(test_truncated_recording_stops);
+    RUN_TEST(test_recording_with_more_channels_is_clamped);
+    RUN_TEST(test_ten_minutes_capture);
+    return UNITY_END();
+}
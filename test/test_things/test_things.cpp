@@ -0,0 +1,167 @@
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include <Things.h>
+#include <MemoryPixelStrip.h>
+
+// 4 universes of 170 RGB pixels
+static const uint16_t PIXELS = 680;
+static const uint32_t FRAMES = 2000;
+
+/**
+ * RGB slice before the ColorLut, kept to compare with: each pixel gamma corrected by NeoGamma, dimmed in double precision
+ * and written if it differs.
+ */
+class LegacyRgbThing : public SliceThingBase<RgbColor> {
+    private:
+        PixelStrip<RgbColor>* strip;
+        static NeoGamma<NeoGammaTableMethod> colorGamma;
+
+    protected:
+        void doSetColor(uint16_t px, RgbColor color, uint8_t dimm) {
+            auto stripPx = pxFrom + px;
+            auto gColor = colorGamma.Correct(color);
+            auto dimmFactor = dimm / 255.0;
+            auto gColorDimm = RgbColor(gColor.R * dimmFactor, gColor.G * dimmFactor, gColor.B * dimmFactor);
+            if (strip->GetPixelColor(stripPx) != gColorDimm) {
+                strip->SetPixelColor(stripPx, gColorDimm);
+            }
+        }
+
+        void doFill(RgbColor color, uint8_t dimm) {
+            for (int px = 0; px < size(); px++) {
+                doSetColor(px, color, dimm);
+            }
+        }
+
+    public:
+        LegacyRgbThing(PixelStrip<RgbColor>* strip, int pxFrom, int pxTo):
+                SliceThingBase<RgbColor>(pxFrom, pxTo, true, nullptr),
+                strip(strip) {
+        }
+
+        int numChannels() {
+            return 4;
+        }
+
+        void setData(uint8_t* data) {
+            setColor(RgbColor(data[0], data[1], data[2]), data[3]);
+        }
+};
+
+NeoGamma<NeoGammaTableMethod> LegacyRgbThing::colorGamma;
+
+static double nanosSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_pixel_map_skips_the_end_of_universes() {
+    ColorLut lut;
+    MemoryPixelStrip<RgbColor> strip(171);
+    PixelMapThing<RgbColor> thing(&strip, true, &lut);
+    // 170 pixels in the 1st universe, 1 pixel and the dimmer in the 2nd
+    TEST_ASSERT_EQUAL(512 + 3 + 1, thing.numChannels());
+    uint8_t data[1024] = {};
+    data[0] = 255; // R of the 1st pixel
+    data[510] = 255; // skipped
+    data[512 + 1] = 255; // G of the last pixel
+    data[512 + 3] = 255; // dimmer
+    thing.setData(data);
+    TEST_ASSERT_TRUE(strip.IsDirty());
+    TEST_ASSERT_TRUE(strip.GetPixelColor(0) == RgbColor(255, 0, 0));
+    TEST_ASSERT_TRUE(strip.GetPixelColor(169) == RgbColor(0, 0, 0));
+    TEST_ASSERT_TRUE(strip.GetPixelColor(170) == RgbColor(0, 255, 0));
+}
+
+/**
+ * A strip of 680 pixels updated as a pixel map against one RGB slice per pixel, all the pixels change per frame.
+ */
+void test_pixel_map_benchmark() {
+    ColorLut lut;
+    MemoryPixelStrip<RgbColor> strip(PIXELS);
+    MemoryPixelStrip<RgbColor> sliceStrip(PIXELS);
+    PixelMapThing<RgbColor> pixelMap(&strip, false, &lut);
+    std::vector<RgbThing*> slices;
+    for (uint16_t i = 0; i < PIXELS; i++) {
+        slices.push_back(new RgbThing(&sliceStrip, i, i, false, &lut));
+    }
+    // the pixel map takes 510 channels of each universe, the slices are patched one after another
+    std::vector<uint8_t> mapData(PIXELS / 170 * 512, 0);
+    std::vector<uint8_t> sliceData(PIXELS * 3, 0);
+
+    double nanos = 0;
+    double sliceNanos = 0;
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        for (uint32_t i = 0; i < PIXELS * 3; i++) {
+            uint8_t value = i * 5 + frame * 3;
+            sliceData[i] = value;
+            mapData[i / 510 * 512 + i % 510] = value;
+        }
+        auto start = std::chrono::steady_clock::now();
+        pixelMap.setData(mapData.data());
+        nanos += nanosSince(start);
+        start = std::chrono::steady_clock::now();
+        for (uint16_t i = 0; i < PIXELS; i++) {
+            slices[i]->setData(sliceData.data() + i * 3);
+        }
+        sliceNanos += nanosSince(start);
+    }
+    char message[160];
+    snprintf(message, sizeof(message), "%d pixels: slices %.0f ns/frame (%u bytes of things), pixel map %.0f ns/frame (%u bytes)",
+        PIXELS, sliceNanos / FRAMES, (unsigned int) (PIXELS * sizeof(RgbThing)), nanos / FRAMES, (unsigned int) sizeof(pixelMap));
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(sliceStrip.Pixels(), strip.Pixels(), strip.PixelsSize());
+
+    for (auto slice : slices) {
+        delete slice;
+    }
+}
+
+/**
+ * Pixels of a slice set one by one, the ColorLut against gamma correction and dimming per pixel.
+ */
+void test_color_lut_benchmark() {
+    ColorLut lut;
+    MemoryPixelStrip<RgbColor> strip(PIXELS);
+    MemoryPixelStrip<RgbColor> legacyStrip(PIXELS);
+    RgbThing slice(&strip, 0, PIXELS - 1, true, &lut);
+    LegacyRgbThing legacySlice(&legacyStrip, 0, PIXELS - 1);
+
+    double nanos = 0;
+    double legacyNanos = 0;
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        uint8_t dimm = 255 - frame % 64;
+        auto start = std::chrono::steady_clock::now();
+        for (uint16_t px = 0; px < PIXELS; px++) {
+            legacySlice.setColor(px, RgbColor(px + frame, px * 3, frame), dimm);
+        }
+        legacyNanos += nanosSince(start);
+        start = std::chrono::steady_clock::now();
+        for (uint16_t px = 0; px < PIXELS; px++) {
+            slice.setColor(px, RgbColor(px + frame, px * 3, frame), dimm);
+        }
+        nanos += nanosSince(start);
+    }
+    char message[120];
+    snprintf(message, sizeof(message), "gamma and dimmer: per pixel %.1f ns/pixel, ColorLut %.1f ns/pixel",
+        legacyNanos / FRAMES / PIXELS, nanos / FRAMES / PIXELS);
+    TEST_MESSAGE(message);
+    // the fixed point dimmer rounds differently
+    for (size_t i = 0; i < strip.PixelsSize(); i++) {
+        TEST_ASSERT_TRUE(abs(strip.Pixels()[i] - legacyStrip.Pixels()[i]) <= 1);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pixel_map_skips_the_end_of_universes);
+    RUN_TEST(test_pixel_map_benchmark);
+    RUN_TEST(test_color_lut_benchmark);
+    return UNITY_END();
+}